@@ -0,0 +1,181 @@
+#include "sched.h"
+#include "FcStack.h"
+#include "Stack_Private.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static STACK_ERROR stack_log_error(const STACK_ERROR error, const FcStack *stack){
+    return stack_log_error(error, stack == NULL ? (const Stack*)NULL : &stack->stack);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#ifdef STACK_META_INFORMATION
+STACK_ERROR stack_init_meta(FcStack* stack, Location location){
+#else
+STACK_ERROR stack_init(FcStack *stack){
+#endif
+    STACK_CHECK_NULL(stack);
+
+    if(stack_is_init(&stack->stack)){                   //Before slots are reset, so published requests survive
+        return stack_log_error(STACK_REINIT, stack);
+    }
+
+    for(size_t i = 0; i < STACK_FC_SLOTS; ++i){
+        stack->slots[i].op.store(FC_STACK_NONE, std::memory_order_relaxed);
+        stack->slots[i].taken.store(false, std::memory_order_relaxed);
+    }
+    stack->slots_used.store(0, std::memory_order_relaxed);
+    stack->combining.store(false, std::memory_order_release);
+
+#ifdef STACK_META_INFORMATION
+    return stack_init_meta(&stack->stack, location);
+#else
+    return stack_init(&stack->stack);
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void stack_free(FcStack *stack){
+    if(stack == NULL) return;
+    stack_free(&stack->stack);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR fc_stack_attach(FcStack *stack, size_t *slot){
+    STACK_CHECK_NULL(stack);
+    LOG_ASSERT(slot != NULL);
+
+    for(size_t i = 0; i < STACK_FC_SLOTS; ++i){
+        bool taken = false;
+        if(stack->slots[i].taken.compare_exchange_strong(taken, true, std::memory_order_acquire)){
+            size_t used = stack->slots_used.load(std::memory_order_relaxed);
+            while(used < i + 1 && !stack->slots_used.compare_exchange_weak(used, i + 1, std::memory_order_release)){}
+            *slot = i;
+            return STACK_ERRNO;
+        }
+    }
+    return stack_log_error(STACK_NO_SLOT, stack);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void fc_stack_detach(FcStack *stack, size_t slot){
+    LOG_ASSERT(stack != NULL);
+    LOG_ASSERT(slot < STACK_FC_SLOTS);
+
+    stack->slots[slot].taken.store(false, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Applies all published requests as one batch. Called only by the thread holding stack->combining.
+ * Stack is checked once before and once after the batch and rehashed once.
+ */
+static void fc_stack_combine(FcStack *stack){
+    Stack* base = &stack->stack;
+    int    ops[STACK_FC_SLOTS] = {};
+    size_t pushes = 0;
+    size_t used   = stack->slots_used.load(std::memory_order_acquire);
+
+    for(size_t i = 0; i < used; ++i){          //Snapshot of requests. Later ones wait for next batch.
+        ops[i] = stack->slots[i].op.load(std::memory_order_acquire);
+        if(ops[i] == FC_STACK_PUSH)
+            pushes++;
+    }
+
+    STACK_ERROR error = stack_check(base);
+    if(error == STACK_ERRNO && base->size + pushes >= base->capacity){      //Expanding stack once for whole batch
+        size_t new_capacity = base->capacity * 2;
+        while(base->size + pushes >= new_capacity){
+            new_capacity *= 2;
+        }
+        error = stack_realloc(base, new_capacity);
+    }
+
+    if(error == STACK_ERRNO){
+        for(size_t i = 0; i < used; ++i){
+            FcStackSlot* slot = &stack->slots[i];
+            if(ops[i] == FC_STACK_PUSH){
+                base->data[base->size++] = slot->value;
+                slot->error = STACK_ERRNO;
+            }
+            if(ops[i] == FC_STACK_POP){
+                if(base->size == 0){
+                    slot->error = STACK_EMPTY_POP;
+                    continue;
+                }
+                slot->value = base->data[base->size - 1];
+                base->data[--base->size] = 0;       //Clears value and moves size to previous position.
+                slot->error = STACK_ERRNO;
+            }
+        }
+        stack_reHash(base);
+
+        for(size_t i = 0; i < used; ++i){               //Logging after rehash, so dump shows consistent stack.
+            if(ops[i] != FC_STACK_NONE && stack->slots[i].error != STACK_ERRNO)
+                stack_log_error(stack->slots[i].error, base);
+        }
+
+        if(4 * base->size < base->capacity && base->capacity > 4 * MIN_STACK_SZ && base->reserved <= base->capacity / 2)
+            error = stack_realloc(base, base->capacity / 2);
+        if(error == STACK_ERRNO)
+            error = stack_check(base);
+    }
+
+    for(size_t i = 0; i < used; ++i){
+        if(ops[i] == FC_STACK_NONE)
+            continue;
+        if(error != STACK_ERRNO)
+            stack->slots[i].error = error;
+        stack->slots[i].op.store(FC_STACK_NONE, std::memory_order_release);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Publishes request and waits for it. Becomes combiner if nobody combines now.
+ */
+static STACK_ERROR fc_stack_request(FcStack *stack, size_t slot, FC_STACK_OP op){
+    FcStackSlot* request = &stack->slots[slot];
+    request->op.store(op, std::memory_order_release);
+
+    while(request->op.load(std::memory_order_acquire) != FC_STACK_NONE){
+        if(!stack->combining.load(std::memory_order_relaxed) &&
+           !stack->combining.exchange(true, std::memory_order_acquire)){
+            fc_stack_combine(stack);
+            stack->combining.store(false, std::memory_order_release);
+        }
+        else{
+            sched_yield();
+        }
+    }
+    return request->error;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_push(FcStack *stack, size_t slot, stack_element_t val){
+    STACK_CHECK_NULL(stack);
+    LOG_ASSERT(slot < STACK_FC_SLOTS);
+
+    stack->slots[slot].value = val;
+    return fc_stack_request(stack, slot, FC_STACK_PUSH);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_pop(FcStack *stack, size_t slot, stack_element_t *value){
+    STACK_CHECK_NULL(stack);
+    LOG_ASSERT(slot < STACK_FC_SLOTS);
+
+    STACK_ERROR error = fc_stack_request(stack, slot, FC_STACK_POP);
+    if(error == STACK_ERRNO && value != NULL){
+        *value = stack->slots[slot].value;
+    }
+    return error;
+}
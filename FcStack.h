@@ -0,0 +1,83 @@
+#ifndef STACK_FCSTACK_H
+#define STACK_FCSTACK_H
+#include "Stack.h"
+#include <atomic>
+
+#ifndef STACK_FC_SLOTS
+#define STACK_FC_SLOTS 64       //Max amount of threads working with one FcStack at once
+#endif
+
+enum FC_STACK_OP{
+    FC_STACK_NONE,              //No request. Result of previous one is ready
+    FC_STACK_PUSH,
+    FC_STACK_POP,
+};
+
+/*!
+ * Slot publishing requests of one thread.
+ */
+struct alignas(64) FcStackSlot{
+    std::atomic<int>  op    = {FC_STACK_NONE};
+    std::atomic<bool> taken = {false};
+    stack_element_t   value = 0;
+    STACK_ERROR       error = STACK_ERRNO;
+};
+
+/*!
+ * Flat-combining wrapper of Stack for many threads.
+ * Threads publish requests to their slots. One of them becomes combiner and applies all published requests
+ * as single batch with one stack_check() before and after and one rehash.
+ */
+struct FcStack{
+    Stack               stack      = {};
+    std::atomic<bool>   combining  = {false};
+    std::atomic<size_t> slots_used = {0};       //Slots starting from this one were never taken
+    FcStackSlot         slots[STACK_FC_SLOTS];
+};
+
+/*!
+ * Inits combining stack if it wasn't initialized before.
+ * @param stack - stack to init
+ */
+#ifdef STACK_META_INFORMATION
+STACK_ERROR stack_init_meta(FcStack* stack, Location location);
+#else
+STACK_ERROR stack_init(FcStack* stack);
+#endif
+
+/*!
+ * Frees place taken by stack. No thread may use it at this time.
+ * @param stack
+ */
+void stack_free(FcStack* stack);
+
+/*!
+ * Takes free slot for calling thread.
+ * @param stack
+ * @param slot - index of taken slot
+ */
+STACK_ERROR fc_stack_attach(FcStack* stack, size_t* slot);
+
+/*!
+ * Returns slot taken by fc_stack_attach().
+ * @param stack
+ * @param slot
+ */
+void fc_stack_detach(FcStack* stack, size_t slot);
+
+/*!
+ * Pushes value to top of stack.
+ * @param stack - stack
+ * @param slot - slot of calling thread
+ * @param val - value to push
+ */
+STACK_ERROR stack_push(FcStack* stack, size_t slot, stack_element_t val);
+
+/*!
+ * Removes top element from stack and returns it.
+ * @param stack
+ * @param slot - slot of calling thread
+ */
+STACK_ERROR stack_pop(FcStack* stack, size_t slot, stack_element_t* value = NULL);
+
+#endif //STACK_FCSTACK_H
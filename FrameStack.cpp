@@ -0,0 +1,540 @@
+#include "string.h"
+#include "stdint.h"
+#include "FrameStack.h"
+#include "Stack_Private.h"
+
+const size_t MIN_FRAME_STACK_SZ = 32 * STACK_FRAME_ALIGN;
+
+/**
+ * @brief Header placed in front of each frame.
+ * Frame layout: [header][data, aligned][canary, aligned].
+ */
+struct StackFrameHeader{
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    canary_t canary;
+#endif
+    size_t prev;                //Offset of previous frame
+    size_t size;                //Size of frame data in bytes
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+    hash_t hash;
+#endif
+};
+
+static size_t frame_align(size_t size){
+    return (size + STACK_FRAME_ALIGN - 1) / STACK_FRAME_ALIGN * STACK_FRAME_ALIGN;
+}
+
+const size_t STACK_FRAME_HEADER_SZ = (sizeof(StackFrameHeader) + STACK_FRAME_ALIGN - 1) / STACK_FRAME_ALIGN * STACK_FRAME_ALIGN;
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+const size_t STACK_FRAME_TAIL_SZ = (sizeof(canary_t) + STACK_FRAME_ALIGN - 1) / STACK_FRAME_ALIGN * STACK_FRAME_ALIGN;
+#else
+const size_t STACK_FRAME_TAIL_SZ = 0;
+#endif
+
+static STACK_ERROR stack_log_error(const STACK_ERROR error, const FrameStack *stack);
+static STACK_ERROR stack_check(FrameStack *stack);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static size_t frame_bytes(size_t size){
+    return STACK_FRAME_HEADER_SZ + frame_align(size) + STACK_FRAME_TAIL_SZ;
+}
+
+static StackFrameHeader* frame_header(const FrameStack *stack, size_t offset){
+    return (StackFrameHeader*)(stack->data + offset);
+}
+
+static char* frame_data(const FrameStack *stack, size_t offset){
+    return stack->data + offset + STACK_FRAME_HEADER_SZ;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+static hash_t frame_hash(const FrameStack *stack, size_t offset){
+    const StackFrameHeader* header = frame_header(stack, offset);
+    size_t info[] = {header->prev, header->size, hashROT13((const unsigned char*)frame_data(stack, offset), header->size)};
+
+    return hashROT13((const unsigned char*)&info, sizeof(info));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//Hashes fields from data to frames. They have no padding between them, so no garbage gets to hash.
+static hash_t frame_stack_info_hash(const FrameStack *stack){
+    const char* begin = (const char*)&stack->data;
+    const char* end   = (const char*)(&stack->frames + 1);
+    return hashROT13((const unsigned char*)begin, (size_t)(end - begin));
+}
+
+static void frame_reHash(FrameStack *stack, size_t offset){
+    frame_header(stack, offset)->hash = frame_hash(stack, offset);
+}
+
+static void frame_stack_reHash(FrameStack *stack){
+    stack->infoHash = frame_stack_info_hash(stack);
+}
+#else
+static void frame_reHash(FrameStack *stack, size_t offset){}
+static void frame_stack_reHash(FrameStack *stack){}
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+static canary_t frame_canary_value(const FrameStack *stack, size_t offset){
+    return STACK_CANARY_VALUE ^ (canary_t)stack ^ (canary_t)offset;
+}
+
+static canary_t* frame_tail_canary(const FrameStack *stack, size_t offset){
+    return (canary_t*)(frame_data(stack, offset) + frame_align(frame_header(stack, offset)->size));
+}
+
+static void frame_place_canary(FrameStack *stack, size_t offset){
+    frame_header(stack, offset)->canary = frame_canary_value(stack, offset);
+    *frame_tail_canary(stack, offset)   = frame_canary_value(stack, offset);
+}
+
+static int frame_check_canary(const FrameStack *stack, size_t offset){
+    return frame_header(stack, offset)->canary == frame_canary_value(stack, offset) &&
+           *frame_tail_canary(stack, offset)   == frame_canary_value(stack, offset);
+}
+#else
+static void frame_place_canary(FrameStack *stack, size_t offset){}
+static int frame_check_canary(const FrameStack *stack, size_t offset){return 1;}
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int frame_stack_is_init(const FrameStack *stack){
+    return stack != NULL && stack->data != NULL && stack->capacity != 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static STACK_ERROR stack_log_error(const STACK_ERROR error, const FrameStack *stack){
+    stack_log_error_message(error);
+#ifdef STACK_ERROR_DUMP
+    STACK_DUMP(stack);
+#endif
+    return stack_raise_error(error);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Checks one frame without logging. Frame must end exactly at [end].
+ * Bounds are checked at any protection level, as header and tail canary are read through them.
+ */
+static STACK_ERROR frame_check(const FrameStack *stack, size_t offset, size_t end){
+    if(end > stack->capacity || offset >= end || end - offset < frame_bytes(0)){
+        return STACK_SIZE_CORRUPTED;
+    }
+    size_t size = frame_header(stack, offset)->size;
+    if(size > end - offset || end - offset != frame_bytes(size)){
+        return STACK_SIZE_CORRUPTED;
+    }
+
+    if(!frame_check_canary(stack, offset)){
+        return STACK_CANARY_DEATH;
+    }
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+    if(frame_hash(stack, offset) != frame_header(stack, offset)->hash){
+        return STACK_DATA_CORRUPTED;
+    }
+#endif
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Checks stack information and top frame only, so every operation costs O(size of top frame).
+ * Frames below top are checked by stack_check_frames().
+ */
+static STACK_ERROR stack_check(FrameStack *stack){
+    if(stack == NULL){
+        return stack_log_error(STACK_NULL, stack);
+    }
+
+#if (STACK_PROTECTION_LEVEL) & STACK_VALID_CHECK
+    if(!frame_stack_is_init(stack)){
+        return stack_log_error(STACK_UNINITIALIZED, stack);
+    }
+#endif
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+    if(frame_stack_info_hash(stack) != stack->infoHash){
+        return stack_log_error(STACK_INFO_CORRUPTED, stack);
+    }
+#endif
+
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    canary_t local_canary_value = STACK_CANARY_VALUE ^ (canary_t)stack;
+    if(stack->canary_beg != local_canary_value || stack->canary_end != local_canary_value){
+        return stack_log_error(STACK_CANARY_DEATH, stack);
+    }
+#endif
+
+#if (STACK_PROTECTION_LEVEL) & STACK_VALID_CHECK
+    if(stack->size > stack->capacity || (stack->frames == 0 && stack->size != 0)){
+        return stack_log_error(STACK_SIZE_CORRUPTED, stack);
+    }
+#endif
+
+    if(stack->frames != 0){
+        STACK_ERROR error = frame_check(stack, stack->top, stack->size);
+        if(error != STACK_ERRNO){
+            return stack_log_error(error, stack);
+        }
+    }
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static STACK_ERROR frame_stack_realloc(FrameStack *stack, size_t new_capacity){
+    STACK_CHECK(stack)
+    if(stack->size > new_capacity){
+        return stack_log_error(STACK_WRONG_REALLOC, stack);
+    }
+
+    char* newData = (char*)realloc(stack->data, new_capacity);
+    if(newData == NULL){
+        return stack_log_error(STACK_BAD_REALLOC, stack);
+    }
+    if(new_capacity > stack->capacity){
+        memset(newData + stack->capacity, 0, new_capacity - stack->capacity);
+    }
+    stack->data     = newData;
+    stack->capacity = new_capacity;
+
+    frame_stack_reHash(stack);
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Bumps stack by one frame of [size] bytes. Copies [src] to frame if it is not NULL,
+ * leaves frame zeroed otherwise. Frame is hashed once.
+ */
+static STACK_ERROR frame_stack_bump(FrameStack *stack, size_t size, const void *src){
+    STACK_CHECK(stack)
+    if(size > SIZE_MAX / 4){
+        return stack_log_error(STACK_BAD_ALLOC, stack);
+    }
+
+    size_t bytes = frame_bytes(size);
+    if(stack->capacity - stack->size < bytes){          //Expanding stack
+        size_t new_capacity = stack->capacity * 2;
+        while(new_capacity - stack->size < bytes){
+            new_capacity *= 2;
+        }
+
+        STACK_ERROR error = frame_stack_realloc(stack, new_capacity);
+        if(error != STACK_ERRNO){
+            return error;
+        }
+    }
+
+    size_t offset = stack->size;
+    memset(stack->data + offset, 0, bytes);
+
+    StackFrameHeader* header = frame_header(stack, offset);
+    header->prev = stack->top;
+    header->size = size;
+    if(src != NULL && size != 0){
+        memcpy(frame_data(stack, offset), src, size);
+    }
+    frame_place_canary(stack, offset);
+    frame_reHash(stack, offset);
+
+    stack->top   = offset;
+    stack->size += bytes;
+    stack->frames++;
+
+    frame_stack_reHash(stack);
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#ifdef STACK_META_INFORMATION
+STACK_ERROR stack_init_meta(FrameStack* stack, Location location){
+#else
+STACK_ERROR stack_init(FrameStack *stack){
+#endif
+    STACK_CHECK_NULL(stack);
+
+    if(frame_stack_is_init(stack)){
+        return stack_log_error(STACK_REINIT, stack);
+    }
+    #ifdef STACK_META_INFORMATION
+        stack->location = location;
+    #endif
+
+    stack->data = (char*)calloc(MIN_FRAME_STACK_SZ, 1);
+    if(stack->data == NULL) {
+        return stack_log_error(STACK_BAD_ALLOC, stack);
+    }
+
+    stack->capacity = MIN_FRAME_STACK_SZ;
+    stack->size     = 0;
+    stack->top      = 0;
+    stack->frames   = 0;
+
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    stack->canary_beg = STACK_CANARY_VALUE ^ (canary_t)stack;
+    stack->canary_end = STACK_CANARY_VALUE ^ (canary_t)stack;
+#endif
+    frame_stack_reHash(stack);
+
+    STACK_CHECK(stack)
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void stack_free(FrameStack *stack){
+    if(stack == NULL) return;
+    if(stack->data != NULL){
+        free(stack->data);
+        stack->data     = NULL;
+        stack->capacity = 0;
+        stack->size     = 0;
+        stack->top      = 0;
+        stack->frames   = 0;
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+        stack->infoHash = 0;
+#endif
+
+    }
+    else{
+        stack_log_error(STACK_REFREE, stack);
+    }
+    return;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_push_frame(FrameStack *stack, size_t size){
+    return frame_stack_bump(stack, size, NULL);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Removes top frame of checked stack. Checks new top frame after.
+ */
+static STACK_ERROR frame_stack_drop(FrameStack *stack){
+    size_t offset = stack->top;
+    stack->top = frame_header(stack, offset)->prev;
+    memset(stack->data + offset, 0, stack->size - offset);     //Clears frame.
+    stack->size = offset;
+    stack->frames--;
+    if(stack->frames == 0){
+        stack->top = 0;
+    }
+    frame_stack_reHash(stack);
+
+    if(4 * stack->size < stack->capacity && stack->capacity > 4 * MIN_FRAME_STACK_SZ)
+        return frame_stack_realloc(stack, stack->capacity / 2);
+
+    STACK_CHECK(stack)
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_pop_frame(FrameStack *stack){
+    STACK_CHECK(stack)
+
+    if(stack->frames == 0){
+        return stack_log_error(STACK_EMPTY_POP, stack);
+    }
+    return frame_stack_drop(stack);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_push_bytes(FrameStack *stack, const void *ptr, size_t len){
+    LOG_ASSERT(ptr != NULL || len == 0);
+
+    return frame_stack_bump(stack, len, ptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_pop_bytes(FrameStack *stack, void *ptr, size_t len){
+    STACK_CHECK(stack)
+
+    if(stack->frames == 0){
+        return stack_log_error(STACK_EMPTY_POP, stack);
+    }
+    if(frame_header(stack, stack->top)->size != len){
+        return stack_log_error(STACK_FRAME_OUT_OF_RANGE, stack);
+    }
+
+    if(ptr != NULL && len != 0){
+        memcpy(ptr, frame_data(stack, stack->top), len);
+    }
+    return frame_stack_drop(stack);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_frame_size(FrameStack *stack, size_t *size){
+    STACK_CHECK(stack)
+    LOG_ASSERT(size != NULL);
+
+    if(stack->frames == 0){
+        return stack_log_error(STACK_EMPTY_GET, stack);
+    }
+
+    *size = frame_header(stack, stack->top)->size;
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_frame_read(FrameStack *stack, size_t offset, void *ptr, size_t len){
+    STACK_CHECK(stack)
+    LOG_ASSERT(ptr != NULL);
+
+    if(stack->frames == 0){
+        return stack_log_error(STACK_EMPTY_GET, stack);
+    }
+    size_t size = frame_header(stack, stack->top)->size;
+    if(len > size || offset > size - len){
+        return stack_log_error(STACK_FRAME_OUT_OF_RANGE, stack);
+    }
+
+    memcpy(ptr, frame_data(stack, stack->top) + offset, len);
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_frame_write(FrameStack *stack, size_t offset, const void *ptr, size_t len){
+    STACK_CHECK(stack)
+    LOG_ASSERT(ptr != NULL);
+
+    if(stack->frames == 0){
+        return stack_log_error(STACK_FRAME_OUT_OF_RANGE, stack);
+    }
+    size_t size = frame_header(stack, stack->top)->size;
+    if(len > size || offset > size - len){
+        return stack_log_error(STACK_FRAME_OUT_OF_RANGE, stack);
+    }
+
+    memcpy(frame_data(stack, stack->top) + offset, ptr, len);
+    frame_reHash(stack, stack->top);
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_check_frames(FrameStack *stack){
+    STACK_CHECK(stack)
+
+    size_t end    = stack->size;
+    size_t offset = stack->top;
+    for(size_t i = 0; i < stack->frames; ++i){
+        STACK_ERROR error = frame_check(stack, offset, end);
+        if(error != STACK_ERRNO){
+            return stack_log_error(error, stack);
+        }
+
+        end    = offset;
+        offset = frame_header(stack, offset)->prev;
+    }
+
+#if (STACK_PROTECTION_LEVEL) & STACK_VALID_CHECK
+    if(end != 0){
+        return stack_log_error(STACK_SIZE_CORRUPTED, stack);
+    }
+#endif
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void stack_dump(const FrameStack *stack, Location location){
+    LOG_MESSAGE_F(DEBUG, "Dumping variable \"%s\" in \"%s(%i)\" in file \"%s\":\n", location.var_name, location.func, location.line, location.filename);
+    LOG_MESSAGE_F(DEBUG, "\n");
+    if (stack == NULL){
+        LOG_MESSAGE_F(DEBUG,"FrameStack [%p];", stack);
+        return;
+    }
+#ifdef STACK_META_INFORMATION
+    LOG_MESSAGE_F(DEBUG,"FrameStack \"%s\" born in \"%s(%i)\" in file: \"%s\" [%p]\n", stack->location.var_name, stack->location.func, stack->location.line , stack->location.filename, stack);
+#else
+    LOG_DEBUG_F("FrameStack [%p]{\n", stack);
+#endif
+    #if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+        canary_t local_canary_value = STACK_CANARY_VALUE ^ (canary_t)stack;
+        LOG_MESSAGE_F(DEBUG, "\t.canary_beg = ");
+        LOG_MESSAGE_F(NO_CAP, "0x%0llx", (unsigned long long)stack->canary_beg);
+        LOG_MESSAGE_F(NO_CAP, "\t\t(%s),\n", (stack->canary_beg == local_canary_value ? "ok" : "ERROR"));
+    #endif
+
+    LOG_MESSAGE_F(DEBUG, "\t.size = %zu,\n", stack->size);
+    LOG_MESSAGE_F(DEBUG, "\t.capacity = %zu,\n", stack->capacity);
+    LOG_MESSAGE_F(DEBUG, "\t.top = %zu,\n", stack->top);
+    LOG_MESSAGE_F(DEBUG, "\t.frames = %zu,\n", stack->frames);
+
+    #if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+        LOG_MESSAGE_F(DEBUG, "\t.infoHash = 0x%0x\t\t\t\t(%s)\n", stack->infoHash,
+                      (stack->infoHash == frame_stack_info_hash(stack) ? "ok" : "ERROR"));
+    #endif
+
+    LOG_MESSAGE_F(DEBUG, "\t.data[%p] = {\n", stack->data);
+
+    if( stack->data != NULL && stack->size <= stack->capacity
+        #if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+        && stack->infoHash == frame_stack_info_hash(stack)
+        #endif
+        )
+    {
+//###################################### Frames dumping begin ##########################################################
+        size_t end    = stack->size;
+        size_t offset = stack->top;
+        for(size_t i = 0; i < stack->frames; ++i){
+            if(offset >= end || end - offset < frame_bytes(0)){
+                LOG_MESSAGE_F(DEBUG, "\t\tFrame chain is broken\n");
+                break;
+            }
+            const StackFrameHeader* header = frame_header(stack, offset);
+            LOG_MESSAGE_F(DEBUG, "\t\t[%03zu] at %zu: .size = %zu, .prev = %zu", stack->frames - 1 - i, offset, header->size, header->prev);
+            if(end - offset != frame_bytes(header->size)){
+                LOG_MESSAGE_F(NO_CAP, " (size ERROR)\n");
+                break;
+            }
+            LOG_MESSAGE_F(NO_CAP, " canary (%s)", (frame_check_canary(stack, offset) ? "ok" : "ERROR"));
+        #if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+            LOG_MESSAGE_F(NO_CAP, " hash 0x%0x (%s)", header->hash, (frame_hash(stack, offset) == header->hash ? "ok" : "ERROR"));
+        #endif
+            if(i == 0)
+                LOG_MESSAGE_F(NO_CAP, " (<--LAST)");
+            LOG_MESSAGE_F(NO_CAP, "\n");
+
+            end    = offset;
+            offset = header->prev;
+        }
+//###################################### Frames dumping end ############################################################
+    }
+    else{
+        LOG_MESSAGE_F(DEBUG, "\tUnable to dump stack. Info is corrupted\n}\n");
+    }
+    LOG_MESSAGE_F(DEBUG, "\t}\n");
+
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    LOG_MESSAGE_F(DEBUG, "\t.canary_end = ");
+    LOG_MESSAGE_F(NO_CAP, "0x%0llx", (unsigned long long)stack->canary_end);
+    LOG_MESSAGE_F(NO_CAP, "\t\t(%s),\n", (stack->canary_end == local_canary_value ? "ok" : "ERROR"));
+#endif
+
+    LOG_MESSAGE_F(DEBUG, "}\n");
+}
@@ -0,0 +1,144 @@
+#ifndef STACK_FRAMESTACK_H
+#define STACK_FRAMESTACK_H
+#include "Stack.h"
+#include "stddef.h"
+#include <type_traits>
+
+/*!
+ * Byte-addressed stack of variable-size frames.
+ * Every frame is allocated with one bump of [size] and is aligned to STACK_FRAME_ALIGN.
+ * Each frame carries its own canaries and hash, so one FrameStack can replace several
+ * parallel Stacks (locals, return addresses, operands) of an interpreter.
+ * Frame contents are accessed by offsets inside top frame, so growth of the stack invalidates nothing.
+ */
+struct FrameStack{
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    canary_t canary_beg = 0;
+#endif
+    char*  data     = NULL;
+
+    size_t capacity = 0;        //Bytes allocated
+    size_t size     = 0;        //Bytes taken by frames
+    size_t top      = 0;        //Offset of top frame
+    size_t frames   = 0;        //Amount of frames
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+    hash_t infoHash = 0;
+#endif
+#ifdef STACK_META_INFORMATION
+    Location location  = {};
+#endif
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    canary_t canary_end = 0;
+#endif
+};
+
+const size_t STACK_FRAME_ALIGN = alignof(max_align_t);
+
+/*!
+ * Inits frame stack if it wasn't initialized before.
+ * @param stack - stack to init
+ */
+#ifdef STACK_META_INFORMATION
+STACK_ERROR stack_init_meta(FrameStack* stack, Location location);
+#else
+STACK_ERROR stack_init(FrameStack* stack);
+#endif
+
+/*!
+ * Frees place taken by frame stack.
+ * @param stack
+ */
+void stack_free(FrameStack* stack);
+
+/*!
+ * Pushes new zeroed frame of [size] bytes to top of stack.
+ * @param stack
+ * @param size - size of frame in bytes
+ */
+STACK_ERROR stack_push_frame(FrameStack* stack, size_t size);
+
+/*!
+ * Removes top frame from stack.
+ * @param stack
+ */
+STACK_ERROR stack_pop_frame(FrameStack* stack);
+
+/*!
+ * Pushes frame holding copy of [len] bytes from [ptr].
+ * @param stack
+ * @param ptr - bytes to push
+ * @param len - amount of bytes
+ */
+STACK_ERROR stack_push_bytes(FrameStack* stack, const void* ptr, size_t len);
+
+/*!
+ * Copies top frame to [ptr] and removes it. Frame size must be equal to [len].
+ * @param stack
+ * @param ptr - destination, may be NULL
+ * @param len - amount of bytes
+ */
+STACK_ERROR stack_pop_bytes(FrameStack* stack, void* ptr, size_t len);
+
+/*!
+ * Returns size of top frame.
+ * @param stack
+ * @param size - size of frame in bytes
+ */
+STACK_ERROR stack_frame_size(FrameStack* stack, size_t* size);
+
+/*!
+ * Copies [len] bytes at [offset] of top frame to [ptr].
+ * @param stack
+ * @param offset - offset inside frame
+ * @param ptr - destination
+ * @param len - amount of bytes
+ */
+STACK_ERROR stack_frame_read(FrameStack* stack, size_t offset, void* ptr, size_t len);
+
+/*!
+ * Copies [len] bytes from [ptr] to [offset] of top frame and updates frame hash.
+ * @param stack
+ * @param offset - offset inside frame
+ * @param ptr - source
+ * @param len - amount of bytes
+ */
+STACK_ERROR stack_frame_write(FrameStack* stack, size_t offset, const void* ptr, size_t len);
+
+/*!
+ * Typed read of top frame.
+ * @param stack
+ * @param offset - offset inside frame
+ * @param value - destination
+ */
+template<typename T>
+STACK_ERROR stack_frame_get(FrameStack* stack, size_t offset, T* value){
+    static_assert(std::is_trivially_copyable<T>::value, "Frame holds only trivially copyable values");
+    return stack_frame_read(stack, offset, value, sizeof(T));
+}
+
+/*!
+ * Typed write to top frame.
+ * @param stack
+ * @param offset - offset inside frame
+ * @param value - value to write
+ */
+template<typename T>
+STACK_ERROR stack_frame_set(FrameStack* stack, size_t offset, const T& value){
+    static_assert(std::is_trivially_copyable<T>::value, "Frame holds only trivially copyable values");
+    return stack_frame_write(stack, offset, &value, sizeof(T));
+}
+
+/*!
+ * Checks all frames of stack. Other functions check only top frame to stay O(size of top frame).
+ * @param stack
+ */
+STACK_ERROR stack_check_frames(FrameStack* stack);
+
+/*!
+ * Dumps frame stack info to log.
+ * @param stack
+ */
+void stack_dump(const FrameStack *stack, Location location);
+
+#endif //STACK_FRAMESTACK_H
@@ -0,0 +1,478 @@
+#include "errno.h"
+#include <atomic>
+#include "time.h"
+#include "unistd.h"
+#include "ShmStack.h"
+#include "Stack_Private.h"
+
+/**
+ * @brief Memory layout: [ShmStack][canary][data][canary]
+ */
+const size_t SHM_STACK_DATA_OFFSET = (sizeof(ShmStack) + sizeof(u_int64_t) - 1) / sizeof(u_int64_t) * sizeof(u_int64_t);
+
+static STACK_ERROR stack_log_error(const STACK_ERROR error, const ShmStack *stack);
+static STACK_ERROR stack_check(ShmStack *stack);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static char* shm_stack_raw_data(const ShmStack *stack){
+    return (char*)stack + stack->data_offset;
+}
+
+static stack_element_t* shm_stack_data(const ShmStack *stack){
+    return (stack_element_t*)(shm_stack_raw_data(stack) + STACK_CANARY_SZ / 2 * sizeof(canary_t));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+static hash_t shm_stack_data_hash(const ShmStack *stack){
+    return hashROT13((const unsigned char*)shm_stack_data(stack), stack->capacity * sizeof(stack_element_t));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//Hashes fields from seed to size. Lock and journal are not hashed as they change inside of every operation.
+static hash_t shm_stack_info_hash(const ShmStack *stack){
+    const char* begin = (const char*)&stack->seed;
+    const char* end   = (const char*)(&stack->size + 1);
+    return hashROT13((const unsigned char*)begin, (size_t)(end - begin));
+}
+
+static void shm_stack_reHash(ShmStack *stack){
+    stack->dataHash = shm_stack_data_hash(stack);
+    stack->infoHash = shm_stack_info_hash(stack);
+}
+#else
+static void shm_stack_reHash(ShmStack *stack){}
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+static canary_t* shm_stack_canary_end(const ShmStack *stack){
+    return (canary_t*)(shm_stack_data(stack) + stack->capacity);
+}
+
+static int shm_stack_check_canary(const ShmStack *stack){
+    canary_t local_canary_value = STACK_CANARY_VALUE ^ stack->seed;
+    return (*(canary_t*)shm_stack_raw_data(stack) == local_canary_value &&
+            *shm_stack_canary_end(stack)          == local_canary_value &&
+            stack->canary_beg                     == local_canary_value &&
+            stack->canary_end                     == local_canary_value);
+}
+
+static void shm_stack_place_canary(ShmStack *stack){
+    canary_t local_canary_value = STACK_CANARY_VALUE ^ stack->seed;
+    *(canary_t*)shm_stack_raw_data(stack) = local_canary_value;
+    *shm_stack_canary_end(stack)          = local_canary_value;
+    stack->canary_beg                     = local_canary_value;
+    stack->canary_end                     = local_canary_value;
+}
+#else
+static int shm_stack_check_canary(const ShmStack *stack){return 1;}
+static void shm_stack_place_canary(ShmStack *stack){}
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static STACK_ERROR stack_log_error(const STACK_ERROR error, const ShmStack *stack){
+    stack_log_error_message(error);
+#ifdef STACK_ERROR_DUMP
+    STACK_DUMP(stack);
+#endif
+    return stack_raise_error(error);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Checks stack without logging, so it is safe to call while holding the lock.
+ */
+static STACK_ERROR shm_stack_validate(const ShmStack *stack){
+    if(stack == NULL){
+        return STACK_NULL;
+    }
+
+#if (STACK_PROTECTION_LEVEL) & STACK_VALID_CHECK
+    if(stack->capacity == 0){
+        return STACK_UNINITIALIZED;
+    }
+
+    if(stack->data_offset != SHM_STACK_DATA_OFFSET){
+        return STACK_VALID_FAIL;
+    }
+#endif
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+    if(shm_stack_info_hash(stack) != stack->infoHash){
+        return STACK_INFO_CORRUPTED;
+    }
+
+    if(shm_stack_data_hash(stack) != stack->dataHash){
+        return STACK_DATA_CORRUPTED;
+    }
+#endif
+
+    if(!shm_stack_check_canary(stack)){
+        return STACK_CANARY_DEATH;
+    }
+
+#if (STACK_PROTECTION_LEVEL) & STACK_VALID_CHECK
+    if(stack->size > stack->capacity){
+        return STACK_SIZE_CORRUPTED;
+    }
+#endif
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static STACK_ERROR stack_check(ShmStack *stack){
+    STACK_ERROR error = shm_stack_validate(stack);
+    if(error != STACK_ERRNO){
+        return stack_log_error(error, stack);
+    }
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Marks operation as pending. Journal is written before the mark, so a process dying at any point
+ * leaves either no pending operation or a complete journal entry.
+ */
+static void shm_stack_journal_begin(ShmStack *stack, SHM_STACK_OP op, stack_element_t value){
+    stack->pending_size  = stack->size;
+    stack->pending_value = value;
+    std::atomic_thread_fence(std::memory_order_release);
+    stack->pending_op    = op;
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void shm_stack_journal_end(ShmStack *stack){
+    std::atomic_thread_fence(std::memory_order_release);
+    stack->pending_op = SHM_STACK_NO_OP;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Rolls back operation interrupted by death of its process and rehashes stack.
+ */
+static void shm_stack_rollback(ShmStack *stack){
+    if(stack->pending_op == SHM_STACK_NO_OP)
+        return;
+
+    if(stack->data_offset == SHM_STACK_DATA_OFFSET && stack->pending_size <= stack->capacity){
+        stack_element_t* data = shm_stack_data(stack);
+        if(stack->pending_op == SHM_STACK_PUSH && stack->pending_size < stack->capacity){
+            data[stack->pending_size] = 0;
+        }
+        if(stack->pending_op == SHM_STACK_POP && stack->pending_size > 0){
+            data[stack->pending_size - 1] = stack->pending_value;
+        }
+        stack->size = stack->pending_size;
+        shm_stack_reHash(stack);
+    }
+    stack->pending_op = SHM_STACK_NO_OP;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Locks stack. If previous owner died, its pending operation is rolled back and stack is checked.
+ * Healthy stack is marked consistent and STACK_OWNER_DEAD is returned with the lock held.
+ * Broken one is unlocked without it, so the lock becomes ENOTRECOVERABLE.
+ * Nothing is logged while the lock is held, so abort() in logger cannot leave the lock owned by dead process.
+ * Warnings and errors of locked operations are logged by shm_stack_unlock().
+ */
+static STACK_ERROR shm_stack_lock(ShmStack *stack){
+    int result = pthread_mutex_lock(&stack->lock);
+    if(result == EOWNERDEAD){
+        shm_stack_rollback(stack);
+        STACK_ERROR error = shm_stack_validate(stack);
+        if(error != STACK_ERRNO){
+            pthread_mutex_unlock(&stack->lock);
+            stack_log_error_message(error);
+            return stack_log_error(STACK_LOCK_FAIL, stack);
+        }
+        pthread_mutex_consistent(&stack->lock);
+        return STACK_OWNER_DEAD;
+    }
+    if(result != 0){
+        return stack_log_error(STACK_LOCK_FAIL, stack);
+    }
+    return STACK_ERRNO;
+}
+
+/**
+ * @brief Unlocks stack, then logs recovery of dead owner and error of locked operation.
+ * @param lock_state - result of shm_stack_lock()
+ * @param error - result of locked operation
+ */
+static STACK_ERROR shm_stack_unlock(ShmStack *stack, STACK_ERROR lock_state, STACK_ERROR error){
+    pthread_mutex_unlock(&stack->lock);
+    if(lock_state == STACK_OWNER_DEAD){
+        stack_log_error(STACK_OWNER_DEAD, stack);
+    }
+    if(error != STACK_ERRNO){
+        return stack_log_error(error, stack);
+    }
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+size_t shm_stack_size(size_t capacity){
+    return SHM_STACK_DATA_OFFSET + capacity * sizeof(stack_element_t) + STACK_CANARY_SZ * sizeof(canary_t);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR shm_stack_create(void *memory, size_t bytes, ShmStack **stack){
+    LOG_ASSERT(stack != NULL);
+    LOG_ASSERT((size_t)memory % alignof(ShmStack) == 0);
+    STACK_CHECK_NULL((ShmStack*)memory);
+
+    if(bytes < shm_stack_size(1)){
+        return stack_log_error(STACK_BAD_ALLOC, (ShmStack*)NULL);
+    }
+
+    ShmStack* new_stack = (ShmStack*)memory;
+    pthread_mutexattr_t attr = {};
+    if(pthread_mutexattr_init(&attr)                                   != 0 ||
+       pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED)     != 0 ||
+       pthread_mutexattr_setrobust (&attr, PTHREAD_MUTEX_ROBUST)       != 0 ||
+       pthread_mutex_init(&new_stack->lock, &attr)                     != 0){
+        pthread_mutexattr_destroy(&attr);
+        return stack_log_error(STACK_LOCK_FAIL, (ShmStack*)NULL);
+    }
+    pthread_mutexattr_destroy(&attr);
+
+    new_stack->seed        = ((u_int64_t)getpid() << 32) ^ (u_int64_t)time(NULL) ^ (u_int64_t)bytes;
+    new_stack->data_offset = SHM_STACK_DATA_OFFSET;
+    new_stack->capacity    = (bytes - shm_stack_size(0)) / sizeof(stack_element_t);
+    new_stack->size        = 0;
+
+    new_stack->pending_op    = SHM_STACK_NO_OP;
+    new_stack->pending_size  = 0;
+    new_stack->pending_value = 0;
+
+    stack_element_t* data = shm_stack_data(new_stack);
+    for(size_t i = 0; i < new_stack->capacity; ++i){
+        data[i] = 0;
+    }
+    shm_stack_place_canary(new_stack);
+    shm_stack_reHash(new_stack);
+
+    STACK_CHECK(new_stack)
+    *stack = new_stack;
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR shm_stack_attach(void *memory, ShmStack **stack){
+    LOG_ASSERT(stack != NULL);
+    ShmStack* shared_stack = (ShmStack*)memory;
+    STACK_CHECK_NULL(shared_stack);
+
+    STACK_ERROR lock_state = shm_stack_lock(shared_stack);
+    if(lock_state != STACK_ERRNO && lock_state != STACK_OWNER_DEAD){
+        return lock_state;
+    }
+    STACK_ERROR error = shm_stack_unlock(shared_stack, lock_state, shm_stack_validate(shared_stack));
+
+    if(error == STACK_ERRNO){
+        *stack = shared_stack;
+    }
+    return error;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void shm_stack_destroy(ShmStack *stack){
+    if(stack == NULL) return;
+    if(stack->capacity != 0){
+        pthread_mutex_destroy(&stack->lock);
+        stack->capacity = 0;
+        stack->size = 0;
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+        stack->infoHash = 0;
+        stack->dataHash = 0;
+#endif
+
+    }
+    else{
+        stack_log_error(STACK_REFREE, stack);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//Locked operations return errors without logging. They are logged after unlock.
+static STACK_ERROR shm_stack_push_locked(ShmStack *stack, stack_element_t val){
+    STACK_ERROR error = shm_stack_validate(stack);
+    if(error != STACK_ERRNO){
+        return error;
+    }
+    if(stack->size == stack->capacity){
+        return STACK_FULL;
+    }
+
+    shm_stack_journal_begin(stack, SHM_STACK_PUSH, 0);
+    shm_stack_data(stack)[stack->size++] = val;
+
+    shm_stack_reHash(stack);
+    shm_stack_journal_end(stack);
+    return shm_stack_validate(stack);
+}
+
+STACK_ERROR stack_push(ShmStack *stack, stack_element_t val){
+    STACK_CHECK_NULL(stack);
+    STACK_ERROR lock_state = shm_stack_lock(stack);
+    if(lock_state != STACK_ERRNO && lock_state != STACK_OWNER_DEAD){
+        return lock_state;
+    }
+
+    STACK_ERROR error = shm_stack_push_locked(stack, val);
+    return shm_stack_unlock(stack, lock_state, error);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static STACK_ERROR shm_stack_get_locked(ShmStack *stack, stack_element_t *value){
+    STACK_ERROR error = shm_stack_validate(stack);
+    if(error != STACK_ERRNO){
+        return error;
+    }
+    if(stack->size == 0){
+        return STACK_EMPTY_GET;
+    }
+
+    *value = shm_stack_data(stack)[stack->size - 1];
+    return STACK_ERRNO;
+}
+
+STACK_ERROR stack_get(ShmStack *stack, stack_element_t *value){
+    STACK_CHECK_NULL(stack);
+    LOG_ASSERT(value != NULL);
+    STACK_ERROR lock_state = shm_stack_lock(stack);
+    if(lock_state != STACK_ERRNO && lock_state != STACK_OWNER_DEAD){
+        return lock_state;
+    }
+
+    STACK_ERROR error = shm_stack_get_locked(stack, value);
+    return shm_stack_unlock(stack, lock_state, error);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static STACK_ERROR shm_stack_pop_locked(ShmStack *stack, stack_element_t *value){
+    STACK_ERROR error = shm_stack_validate(stack);
+    if(error != STACK_ERRNO){
+        return error;
+    }
+    if(stack->size == 0){
+        return STACK_EMPTY_POP;
+    }
+
+    if(value != NULL){
+        *value = shm_stack_data(stack)[stack->size - 1];
+    }
+    shm_stack_journal_begin(stack, SHM_STACK_POP, shm_stack_data(stack)[stack->size - 1]);
+    shm_stack_data(stack)[--stack->size] = 0;     //Clears value and moves size to previous position. Prefix decrement is important.
+
+    shm_stack_reHash(stack);
+    shm_stack_journal_end(stack);
+    return shm_stack_validate(stack);
+}
+
+STACK_ERROR stack_pop(ShmStack *stack, stack_element_t *value){
+    STACK_CHECK_NULL(stack);
+    STACK_ERROR lock_state = shm_stack_lock(stack);
+    if(lock_state != STACK_ERRNO && lock_state != STACK_OWNER_DEAD){
+        return lock_state;
+    }
+
+    STACK_ERROR error = shm_stack_pop_locked(stack, value);
+    return shm_stack_unlock(stack, lock_state, error);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void stack_dump(const ShmStack *stack, Location location){
+    LOG_MESSAGE_F(DEBUG, "Dumping variable \"%s\" in \"%s(%i)\" in file \"%s\":\n", location.var_name, location.func, location.line, location.filename);
+    LOG_MESSAGE_F(DEBUG, "\n");
+    if (stack == NULL){
+        LOG_MESSAGE_F(DEBUG,"ShmStack [%p];", stack);
+        return;
+    }
+    LOG_MESSAGE_F(DEBUG, "ShmStack [%p] in process %i{\n", stack, (int)getpid());
+
+    #if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+        canary_t local_canary_value = STACK_CANARY_VALUE ^ stack->seed;
+        LOG_MESSAGE_F(DEBUG, "\t.canary_beg = ");
+        LOG_MESSAGE_F(NO_CAP, "0x%0llx", (unsigned long long)stack->canary_beg);
+        LOG_MESSAGE_F(NO_CAP, "\t\t(%s),\n", (stack->canary_beg == local_canary_value ? "ok" : "ERROR"));
+    #endif
+
+    LOG_MESSAGE_F(DEBUG, "\t.seed = 0x%0llx,\n", (unsigned long long)stack->seed);
+    LOG_MESSAGE_F(DEBUG, "\t.data_offset = %zu,\n", stack->data_offset);
+    LOG_MESSAGE_F(DEBUG, "\t.size = %zu,\n", stack->size);
+    LOG_MESSAGE_F(DEBUG, "\t.capacity = %zu,\n", stack->capacity);
+
+    #if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+        LOG_MESSAGE_F(DEBUG, "\t.infoHash = 0x%0x\t\t\t\t(%s)\n", stack->infoHash,
+                      (stack->infoHash == shm_stack_info_hash(stack) ? "ok" : "ERROR"));
+    #endif
+
+    LOG_MESSAGE_F(DEBUG, "\t.data[+%zu] = {\n", stack->data_offset);
+
+    if( stack->data_offset == SHM_STACK_DATA_OFFSET && stack->capacity != 0
+        #if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+        && stack->infoHash == shm_stack_info_hash(stack)
+        #endif
+        )
+    {
+//###################################### Data dumping begin ############################################################
+        #if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+            LOG_MESSAGE_F(DEBUG, "\t\t.dataHash = 0x%0x\t\t\t(%s)\n", stack->dataHash,
+                          (stack->dataHash == shm_stack_data_hash(stack) ? "ok" : "ERROR"));
+        #endif
+        #if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+            LOG_MESSAGE_F(DEBUG, "\t\t.canary_beg = ");
+            LOG_MESSAGE_F(NO_CAP, "0x%0llx", (unsigned long long)*(canary_t*)shm_stack_raw_data(stack));
+            LOG_MESSAGE_F(NO_CAP, "\t(%s),\n", (*(canary_t*)shm_stack_raw_data(stack) == local_canary_value ? "ok" : "ERROR"));
+        #endif
+
+        const stack_element_t* data = shm_stack_data(stack);
+        for (size_t i = 0; i < stack->capacity; ++i){
+            LOG_MESSAGE_F(DEBUG, "\t\t[%03zu] = ", i);
+            LOG_MESSAGE_F(NO_CAP, stack_element_format, data[i]);
+            if(i == stack->size - 1)
+                LOG_MESSAGE_F(NO_CAP, " (<--LAST)");
+            LOG_MESSAGE_F(NO_CAP, "\n");
+        }
+
+        #if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+            LOG_MESSAGE_F(DEBUG, "\t\t.canary_end = ");
+            LOG_MESSAGE_F(NO_CAP, "0x%0llx", (unsigned long long)*shm_stack_canary_end(stack));
+            LOG_MESSAGE_F(NO_CAP, "\t(%s),\n", (*shm_stack_canary_end(stack) == local_canary_value ? "ok" : "ERROR"));
+        #endif
+//###################################### Data dumping end ##############################################################
+    }
+    else{
+        LOG_MESSAGE_F(DEBUG, "\tUnable to dump stack. Info is corrupted\n}\n");
+    }
+    LOG_MESSAGE_F(DEBUG, "\t}\n");
+
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    LOG_MESSAGE_F(DEBUG, "\t.canary_end = ");
+    LOG_MESSAGE_F(NO_CAP, "0x%0llx", (unsigned long long)stack->canary_end);
+    LOG_MESSAGE_F(NO_CAP, "\t\t(%s),\n", (stack->canary_end == local_canary_value ? "ok" : "ERROR"));
+#endif
+
+    LOG_MESSAGE_F(DEBUG, "}\n");
+}
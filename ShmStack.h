@@ -0,0 +1,101 @@
+#ifndef STACK_SHMSTACK_H
+#define STACK_SHMSTACK_H
+#include "Stack.h"
+#include "pthread.h"
+
+/*!
+ * Operation in progress, stored in ShmStack::pending_op.
+ */
+enum SHM_STACK_OP{
+    SHM_STACK_NO_OP,
+    SHM_STACK_PUSH,
+    SHM_STACK_POP,
+};
+
+/*!
+ * Position-independent stack of fixed capacity placed in caller's memory (shm_open, memfd, mmap).
+ * Data is found by offset from the beginning of ShmStack and canaries do not depend on addresses,
+ * so the stack stays valid when mapped at different addresses in different processes.
+ * Every operation holds robust process-shared mutex and is journaled, so if a process dies inside of operation,
+ * next owner of the lock rolls it back. Elements live in shared memory, so value pushed
+ * by one process is popped by another without any copying.
+ * @warning With STACK_USE_PTR pointers are meaningful only if memory is mapped at the same address.
+ */
+struct ShmStack{
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    canary_t canary_beg;
+#endif
+    pthread_mutex_t lock;
+    u_int64_t seed;             //Base for canary value. Differs from stack to stack.
+    size_t data_offset;         //Offset of data from beginning of ShmStack
+    size_t capacity;
+    size_t size;
+
+    int             pending_op;     //Operation in progress. Lets next owner roll it back if process dies.
+    size_t          pending_size;   //Size before operation in progress
+    stack_element_t pending_value;  //Value removed by operation in progress
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+    hash_t infoHash;
+    hash_t dataHash;
+#endif
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    canary_t canary_end;
+#endif
+};
+
+/*!
+ * Counts bytes of memory needed for shared stack.
+ * @param capacity - amount of elements
+ * @return size in bytes
+ */
+size_t shm_stack_size(size_t capacity);
+
+/*!
+ * Places new shared stack in [memory]. Capacity is the largest fitting in [bytes].
+ * @param memory - memory aligned at least as ShmStack, e.g. result of mmap()
+ * @param bytes - size of memory
+ * @param stack - pointer to created stack
+ */
+STACK_ERROR shm_stack_create(void* memory, size_t bytes, ShmStack** stack);
+
+/*!
+ * Attaches to shared stack created by shm_stack_create() in any process and checks it.
+ * @param memory - memory holding stack
+ * @param stack - pointer to attached stack
+ */
+STACK_ERROR shm_stack_attach(void* memory, ShmStack** stack);
+
+/*!
+ * Destroys shared stack. Must be called once, when no process uses stack.
+ * @param stack
+ */
+void shm_stack_destroy(ShmStack* stack);
+
+/*!
+ * Pushes value to top of shared stack.
+ * @param stack - stack
+ * @param val - value to push
+ */
+STACK_ERROR stack_push(ShmStack* stack, stack_element_t val);
+
+/*!
+ * Returns top element of shared stack.
+ * @param stack
+ * @return value of top element
+ */
+STACK_ERROR stack_get(ShmStack* stack, stack_element_t* value);
+
+/*!
+ * Removes top element from shared stack and returns it.
+ * @param stack
+ */
+STACK_ERROR stack_pop(ShmStack* stack, stack_element_t* value = NULL);
+
+/*!
+ * Dumps shared stack info to log.
+ * @param stack
+ */
+void stack_dump(const ShmStack* stack, Location location);
+
+#endif //STACK_SHMSTACK_H
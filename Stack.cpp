@@ -1,7 +1,6 @@
 #include "Stack.h"
 #include "Stack_Private.h"
 
-const size_t MIN_STACK_SZ = 8;
 extern const size_t STACK_CANARY_SZ;
 
 #ifdef STACK_META_INFORMATION
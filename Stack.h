@@ -93,6 +93,7 @@ enum STACK_ERROR{
     STACK_EMPTY_GET,            //Getting from empty stack
     STACK_WRONG_REALLOC,        //Inappropriate call of realloc.
     STACK_REFREE,               //Freeing of uninitialized stack
+    STACK_OWNER_DEAD,           //Process holding lock died, stack recovered
 
     STACK_ANY_ERROR,
     //Errors goes here:
@@ -101,6 +102,10 @@ enum STACK_ERROR{
     STACK_BAD_ALLOC,            //Error during   allocation of memory
     STACK_BAD_REALLOC,          //Error during REallocation of memory
     STACK_VALID_FAIL,           //Failed stack_check()
+    STACK_FRAME_OUT_OF_RANGE,   //Access outside of frame bounds
+    STACK_FULL,                 //Pushing to full stack of fixed capacity
+    STACK_LOCK_FAIL,            //Error during locking of shared stack
+    STACK_NO_SLOT,              //All slots of combining stack are taken
 
     STACK_ANY_FATAL,
     //Fatals goes here:
@@ -164,6 +169,16 @@ STACK_ERROR stack_remove(Stack* stack);
  */
 STACK_ERROR stack_reserve(Stack *stack, size_t to_reserve);
 
+/*!
+ * Checks many stacks in parallel. Data of large stacks is hashed by parts in several threads.
+ * Unlike other functions does not dump and raise: errors are logged and returned for each stack.
+ * @param stacks - array of stacks
+ * @param count - amount of stacks
+ * @param results - array of [count] errors, one for each stack
+ * @return STACK_VALID_FAIL if any stack failed, STACK_ERRNO otherwise
+ */
+STACK_ERROR stack_check_many(Stack* const* stacks, size_t count, STACK_ERROR* results);
+
 /*!
  * Dumps stack info to log.
  * @param stack
@@ -0,0 +1,104 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "Stack.h"
+#include "Stack_Private.h"
+
+const size_t STACK_CHECK_CHUNK_SZ = 1 << 16;    //Bytes of data hashed by one task
+
+/**
+ * @brief Hash of part of one stack's data.
+ */
+struct StackCheckTask{
+    size_t stack;                               //Index of stack
+    size_t begin;                               //Offset of part in bytes
+    size_t end;
+    hash_t hash;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Runs func(i) for i in [0, count) on [threads] threads, calling thread included.
+ */
+template<typename Func>
+static void stack_parallel_for(size_t count, size_t threads, Func func){
+    std::atomic<size_t> next = {0};
+    auto worker = [&](){
+        for(size_t i = next++; i < count; i = next++){
+            func(i);
+        }
+    };
+
+    if(threads > count)
+        threads = count;
+
+    std::vector<std::thread> pool;
+    for(size_t i = 1; i < threads; ++i){
+        pool.emplace_back(worker);
+    }
+    worker();
+    for(std::thread& thread: pool){
+        thread.join();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_check_many(Stack* const* stacks, size_t count, STACK_ERROR* results){
+    LOG_ASSERT(stacks  != NULL || count == 0);
+    LOG_ASSERT(results != NULL || count == 0);
+
+    for(size_t i = 0; i < count; ++i){             //O(1) per stack, so only data hashing is parallel
+        results[i] = stack_validate_info(stacks[i]);
+    }
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+    size_t threads = std::thread::hardware_concurrency();
+    if(threads == 0)
+        threads = 1;
+
+    std::vector<StackCheckTask> tasks;
+    for(size_t i = 0; i < count; ++i){
+        if(results[i] != STACK_ERRNO)
+            continue;
+
+        size_t dataBytes = stacks[i]->capacity * sizeof(stack_element_t);
+        for(size_t begin = 0; begin < dataBytes; begin += STACK_CHECK_CHUNK_SZ){
+            size_t end = (dataBytes - begin > STACK_CHECK_CHUNK_SZ) ? begin + STACK_CHECK_CHUNK_SZ : dataBytes;
+            tasks.push_back({i, begin, end, 0});
+        }
+    }
+
+    stack_parallel_for(tasks.size(), threads, [&](size_t i){
+        StackCheckTask* task = &tasks[i];
+        task->hash = hashPoly((const unsigned char*)stacks[task->stack]->data + task->begin, task->end - task->begin);
+    });
+
+    for(size_t i = 0; i < tasks.size();){         //Tasks of one stack go in a row
+        size_t stack = tasks[i].stack;
+        hash_t hash  = 0;
+        for(; i < tasks.size() && tasks[i].stack == stack; ++i){
+            hash = hashPoly_combine(hash, tasks[i].hash, tasks[i].end - tasks[i].begin);
+        }
+        if(hash != stacks[stack]->dataHash){
+            results[stack] = STACK_DATA_CORRUPTED;
+        }
+    }
+#endif
+
+    for(size_t i = 0; i < count; ++i){
+        if(results[i] == STACK_ERRNO)
+            results[i] = stack_validate_bounds(stacks[i]);
+    }
+
+    STACK_ERROR error = STACK_ERRNO;
+    for(size_t i = 0; i < count; ++i){
+        if(results[i] != STACK_ERRNO){
+            LOG_MESSAGE_F(ERROR, "stack_check_many(): stack [%zu] = %p failed:\n", i, stacks[i]);
+            stack_log_error_message(results[i]);
+            error = STACK_VALID_FAIL;
+        }
+    }
+    return error;
+}
@@ -6,7 +6,7 @@ extern const canary_t STACK_CANARY_VALUE;
 
 //----------------------------------------------------------------------------------------------------------------------
 #define caseErr(error, msg) case error: LOG_MESSAGE(errorLevel, #error ": " msg); break
-STACK_ERROR stack_log_error(const STACK_ERROR error, const Stack *stack){
+void stack_log_error_message(const STACK_ERROR error){
     ErrorLevel errorLevel = stack_get_ErrorLevel(error);
     switch(error){
     case STACK_ERRNO:
@@ -24,6 +24,10 @@ STACK_ERROR stack_log_error(const STACK_ERROR error, const Stack *stack){
     caseErr(STACK_DATA_CORRUPTED,   "Found memory leak. Data probably corrupted");
     caseErr(STACK_BAD_ALLOC,        "Initial memory allocation is unsuccessful");
     caseErr(STACK_EMPTY_GET,        "Getting element from empty stack");
+    caseErr(STACK_FRAME_OUT_OF_RANGE, "Access goes over bounds of frame");
+    caseErr(STACK_FULL,             "Pushing to full stack. Capacity is fixed");
+    caseErr(STACK_LOCK_FAIL,        "Unable to lock shared stack");
+    caseErr(STACK_NO_SLOT,          "All slots of combining stack are taken");
 
     //###################### Warnings ############################################################
     caseErr(STACK_ANY_WARNING,      "Unknown warning so be warned");
@@ -33,57 +37,90 @@ STACK_ERROR stack_log_error(const STACK_ERROR error, const Stack *stack){
     caseErr(STACK_REINIT,           "Reinitializing of stack");
     caseErr(STACK_EMPTY_POP,        "Called pop to empty stack");
     caseErr(STACK_REFREE,           "Refreeing of stack");
+    caseErr(STACK_OWNER_DEAD,       "Process holding stack died. Stack is checked and recovered");
     default:
         LOG_MESSAGE(errorLevel, "Unknown error");
     }
-#ifdef STACK_ERROR_DUMP
-    STACK_DUMP(stack);
-#endif
+}
+#undef caseErr
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_raise_error(const STACK_ERROR error){
 #ifndef STACK_NO_FAIL
-    LOG_RAISE(errorLevel);
+    LOG_RAISE(stack_get_ErrorLevel(error));
 #endif
     return error;
 }
-#undef caseErr
 //----------------------------------------------------------------------------------------------------------------------
 
-STACK_ERROR stack_check(Stack *stack){
+STACK_ERROR stack_log_error(const STACK_ERROR error, const Stack *stack){
+    stack_log_error_message(error);
+#ifdef STACK_ERROR_DUMP
+    STACK_DUMP(stack);
+#endif
+    return stack_raise_error(error);
+}
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_validate_info(const Stack *stack){
     if(stack == NULL){
-        return stack_log_error(STACK_NULL, stack);
+        return STACK_NULL;
     }
 
 #if (STACK_PROTECTION_LEVEL) & STACK_VALID_CHECK
     if(!stack_is_init(stack)){
-        return stack_log_error(STACK_UNINITIALIZED, stack);
+        return STACK_UNINITIALIZED;
     }
 
     if((void*)stack->data != (void*)((canary_t*)stack->raw_data + STACK_CANARY_SZ / 2)){        //Check data and raw_data points to one memory
-        return stack_log_error(STACK_VALID_FAIL, stack);
+        return STACK_VALID_FAIL;
     }
 #endif
 
 #if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
     if(stack_info_hash(stack) != stack->infoHash){
-        return stack_log_error(STACK_INFO_CORRUPTED, stack);
-    }
-
-    if(stack_data_hash(stack) != stack->dataHash){
-        return stack_log_error(STACK_DATA_CORRUPTED, stack);
+        return STACK_INFO_CORRUPTED;
     }
 #endif
+    return STACK_ERRNO;
+}
 
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_validate_bounds(const Stack *stack){
 #if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
 
     if(!stack_check_canary(stack)){
-        return stack_log_error(STACK_CANARY_DEATH, stack);
+        return STACK_CANARY_DEATH;
     }
 #endif
 
 #if (STACK_PROTECTION_LEVEL) & STACK_VALID_CHECK
     if(stack->size > stack->capacity || stack->capacity == 0){
-        return stack_log_error(STACK_SIZE_CORRUPTED, stack);
+        return STACK_SIZE_CORRUPTED;
+    }
+#endif
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR stack_check(Stack *stack){
+    STACK_ERROR error = stack_validate_info(stack);
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+    if(error == STACK_ERRNO && stack_data_hash(stack) != stack->dataHash){
+        error = STACK_DATA_CORRUPTED;
     }
 #endif
+
+    if(error == STACK_ERRNO){
+        error = stack_validate_bounds(stack);
+    }
+
+    if(error != STACK_ERRNO){
+        return stack_log_error(error, stack);
+    }
     return STACK_ERRNO;
 }
 
@@ -110,31 +147,51 @@ hash_t hashROT13(const unsigned char *array, const size_t size){
 
 //----------------------------------------------------------------------------------------------------------------------
 
+const hash_t HASH_POLY_BASE = 0x01000193;           //FNV prime. Any odd number works.
+
+hash_t hashPoly(const unsigned char *array, const size_t size){
+    LOG_ASSERT(array != NULL);
+
+    hash_t hash = 0;
+    for(size_t i = 0; i < size; ++i){
+        hash = hash * HASH_POLY_BASE + array[i];
+    }
+    return hash;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+hash_t hashPoly_combine(hash_t left, hash_t right, size_t right_size){
+    hash_t power = 1;
+    hash_t base  = HASH_POLY_BASE;
+    while(right_size != 0){                         //Fast power: left * BASE^right_size
+        if(right_size & 1)
+            power *= base;
+        base *= base;
+        right_size >>= 1;
+    }
+    return left * power + right;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 hash_t stack_data_hash(const Stack *stack){
     LOG_ASSERT(stack != NULL);
     LOG_ASSERT(stack->data != NULL);
 
     size_t dataBytes = stack->capacity * sizeof(stack_element_t);
-    return hashROT13((unsigned char *)stack->data, dataBytes);
+    return hashPoly((unsigned char *)stack->data, dataBytes);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-//!@warning: Stack->infoHash must be ignored. So we have to drop const qualifier.
-//In caused not to allow old stack hash to be part of new hash
+//!@note: Stack->infoHash must be ignored, so copy with cleared hash is hashed.
+//Stack itself is not written, so it may be checked by several threads at once.
 hash_t stack_info_hash(const Stack *stack){
     LOG_ASSERT(stack != NULL);
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wcast-qual"
-
-    Stack* tmp_stack = (Stack*)stack;       // Dropping const qualifier... :((
-
-#pragma GCC diagnostic pop
-
-    hash_t exHash = tmp_stack->infoHash;
-    tmp_stack->infoHash = 0;                //Clearing hash
-    hash_t hash = hashROT13((const unsigned char *)tmp_stack, sizeof(stack));
-    tmp_stack->infoHash = exHash;           //Return to beginning;
+    Stack tmp_stack = *stack;
+    tmp_stack.infoHash = 0;                 //Clearing hash
+    hash_t hash = hashROT13((const unsigned char *)&tmp_stack, sizeof(stack));
 
     return hash;
 }
@@ -155,7 +212,7 @@ void stack_reHash(Stack *stack){}
 //----------------------------------------------------------------------------------------------------------------------
 
 #if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
-int stack_check_canary(Stack *stack){
+int stack_check_canary(const Stack *stack){
     LOG_ASSERT(stack != NULL);
     LOG_ASSERT(stack_is_init(stack));
 
@@ -182,7 +239,7 @@ void stack_place_canary(Stack *stack){
     stack->canary_end                       = local_canary_value;
 }
 #else
-int stack_check_canary(Stack *stack){return 1;}
+int stack_check_canary(const Stack *stack){return 1;}
 void stack_place_canary(Stack *stack){}
 #endif
 
@@ -7,6 +7,8 @@
 #define STACK_CHECK_NULL(stack) if(stack == NULL) return stack_log_error(STACK_NULL, stack)
 #define STACK_CHECK(stack) {STACK_ERROR _error = stack_check(stack);if(_error != STACK_ERRNO) return _error;}
 
+const size_t MIN_STACK_SZ = 8;
+
 #if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
 const size_t STACK_CANARY_SZ = 2;    //Amount of canary values.
 const canary_t STACK_CANARY_VALUE = 0x0fa33af0;
@@ -15,6 +17,19 @@ const size_t STACK_CANARY_SZ = 0;
 #endif
 
 
+/*!
+ * Logs message describing error. Does not dump or raise.
+ * @param error - error to log.
+ */
+void stack_log_error_message(const STACK_ERROR error);
+
+/*!
+ * Raises error unless STACK_NO_FAIL is defined (possible abort()!). Used by every kind of stack after logging.
+ * @param error - error to raise.
+ * @return error
+ */
+STACK_ERROR stack_raise_error(const STACK_ERROR error);
+
 /*!
  * Logs and raises errors.
  * @param error - error to log.
@@ -27,6 +42,20 @@ STACK_ERROR stack_log_error(const STACK_ERROR error, const Stack *stack);
  */
 STACK_ERROR stack_check(Stack *stack);
 
+/*!
+ * Checks stack's internal information without logging. Data is not checked.
+ * @param stack
+ * @return first found error
+ */
+STACK_ERROR stack_validate_info(const Stack *stack);
+
+/*!
+ * Checks canaries and size of stack without logging. Call only when stack_validate_info() succeeded.
+ * @param stack
+ * @return first found error
+ */
+STACK_ERROR stack_validate_bounds(const Stack *stack);
+
 /*!
  * Checks if stack is initialized;
  * @param stack
@@ -49,6 +78,23 @@ hash_t stack_data_hash(const Stack* stack);
  */
 hash_t stack_info_hash(const Stack* stack);
 
+/*!
+ * Counts polynomial hash of array. Hashes of parts may be combined with hashPoly_combine().
+ * @param array - array to hash
+ * @param size - size of array
+ * @return
+ */
+hash_t hashPoly(const unsigned char *array, const size_t size);
+
+/*!
+ * Combines hashes of two adjacent parts of array into hash of whole array.
+ * @param left - hashPoly() of left part
+ * @param right - hashPoly() of right part
+ * @param right_size - size of right part
+ * @return hash of whole array
+ */
+hash_t hashPoly_combine(hash_t left, hash_t right, size_t right_size);
+
 /*!
  * Counts hash of array of data using algorithm. Uses algorithm ROT13
  * @param array - array to hash
@@ -68,7 +114,7 @@ void stack_reHash(Stack* stack);
  * Checks if canary is alive. Causes error.
  * @param stack
  */
-int stack_check_canary(Stack* stack);
+int stack_check_canary(const Stack* stack);
 
 /*!
  * Places canary in stack.
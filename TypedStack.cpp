@@ -0,0 +1,95 @@
+#include "TypedStack.h"
+#include "Stack_Private.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+STACK_ERROR typed_stack_log_error(STACK_ERROR error, const TypedStackDumpInfo *info, Location location){
+    stack_log_error_message(error);
+#ifdef STACK_ERROR_DUMP
+    typed_stack_dump(info, location);
+#endif
+    return stack_raise_error(error);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void typed_stack_dump(const TypedStackDumpInfo *info, Location location){
+    LOG_MESSAGE_F(DEBUG, "Dumping variable \"%s\" in \"%s(%i)\" in file \"%s\":\n", location.var_name, location.func, location.line, location.filename);
+    LOG_MESSAGE_F(DEBUG, "\n");
+    if (info->stack == NULL){
+        LOG_MESSAGE_F(DEBUG,"TypedStack [%p];", info->stack);
+        return;
+    }
+#ifdef STACK_META_INFORMATION
+    LOG_MESSAGE_F(DEBUG,"TypedStack \"%s\" born in \"%s(%i)\" in file: \"%s\" [%p]\n", info->location.var_name, info->location.func, info->location.line , info->location.filename, info->stack);
+#else
+    LOG_DEBUG_F("TypedStack [%p]{\n", info->stack);
+#endif
+    #if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+        LOG_MESSAGE_F(DEBUG, "\t.canary_beg = ");
+        LOG_MESSAGE_F(NO_CAP, "0x%0llx", (unsigned long long)info->canary_beg);
+        LOG_MESSAGE_F(NO_CAP, "\t\t(%s),\n", (info->canary_beg == info->canary_value ? "ok" : "ERROR"));
+    #endif
+
+    LOG_MESSAGE_F(DEBUG, "\t.size = %zu,\n", info->size);
+    LOG_MESSAGE_F(DEBUG, "\t.capacity = %zu,\n", info->capacity);
+    LOG_MESSAGE_F(DEBUG, "\t.reserved = %zu,\n", info->reserved);
+
+    #if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+        LOG_MESSAGE_F(DEBUG, "\t.infoHash = 0x%0x\t\t\t\t(%s)\n", info->infoHash,
+                      (info->infoHash == info->realInfoHash ? "ok" : "ERROR"));
+    #endif
+
+    LOG_MESSAGE_F(DEBUG, "\t.raw_data = %p,\n", info->raw_data);
+    LOG_MESSAGE_F(DEBUG, "\t.data[%p] = {\n", info->data);
+
+    if(info->data_ok){
+//###################################### Data dumping begin ############################################################
+        #if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+            LOG_MESSAGE_F(DEBUG, "\t\t.dataHash = 0x%0x\t\t\t(%s)\n", info->dataHash,
+                          (info->dataHash == info->realDataHash ? "ok" : "ERROR"));
+        #endif
+        #if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+            LOG_MESSAGE_F(DEBUG, "\t\t.canary_beg = ");
+            LOG_MESSAGE_F(NO_CAP, "0x%0llx", (unsigned long long)info->data_canary_beg);
+            LOG_MESSAGE_F(NO_CAP, "\t(%s),\n", (info->data_canary_beg == info->canary_value ? "ok" : "ERROR"));
+        #endif
+
+        LOG_MESSAGE_F(DEBUG, "\t\t%zu elements\n", info->size);
+
+        #if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+            LOG_MESSAGE_F(DEBUG, "\t\t.canary_end = ");
+            LOG_MESSAGE_F(NO_CAP, "0x%0llx", (unsigned long long)info->data_canary_end);
+            LOG_MESSAGE_F(NO_CAP, "\t(%s),\n", (info->data_canary_end == info->canary_value ? "ok" : "ERROR"));
+        #endif
+//###################################### Data dumping end ##############################################################
+    }
+    else{
+        LOG_MESSAGE_F(DEBUG, "\tUnable to dump stack. Info is corrupted\n}\n");
+    }
+    LOG_MESSAGE_F(DEBUG, "\t}\n");
+
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    LOG_MESSAGE_F(DEBUG, "\t.canary_end = ");
+    LOG_MESSAGE_F(NO_CAP, "0x%0llx", (unsigned long long)info->canary_end);
+    LOG_MESSAGE_F(NO_CAP, "\t\t(%s),\n", (info->canary_end == info->canary_value ? "ok" : "ERROR"));
+#endif
+
+    LOG_MESSAGE_F(DEBUG, "}\n");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+canary_t typed_stack_canary(const void *stack){
+    return STACK_CANARY_VALUE ^ (canary_t)stack;
+}
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+hash_t typed_stack_hash(const void *bytes, size_t size){
+    return hashPoly((const unsigned char*)bytes, size);
+}
+#endif
@@ -0,0 +1,561 @@
+#ifndef STACK_TYPEDSTACK_H
+#define STACK_TYPEDSTACK_H
+#include "Stack.h"
+#include "string.h"
+#include "stddef.h"
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*!
+ * Says if object of type T may be moved to other place with memcpy()/realloc().
+ * True for trivially copyable types. Specialize for other types that have no pointers to themselves.
+ */
+template<typename T>
+struct stack_is_trivially_relocatable: std::integral_constant<bool, std::is_trivially_copyable<T>::value>{};
+
+template<typename T, typename Deleter>
+struct stack_is_trivially_relocatable<std::unique_ptr<T, Deleter>>: stack_is_trivially_relocatable<Deleter>{};
+
+/*!
+ * Says if bytes of elements of type T are hashed. True for trivially copyable types.
+ * Specialize to turn on for types whose bytes change only by assignment, or to turn off for big types.
+ */
+template<typename T>
+struct stack_hash_elements: std::integral_constant<bool, std::is_trivially_copyable<T>::value>{};
+
+/*!
+ * Stack of objects of any type, including move-only ones.
+ * Elements are constructed in place, moved out on pop and destroyed properly.
+ * Growth uses realloc() for trivially relocatable types and moves elements one by one otherwise.
+ */
+template<typename T>
+struct TypedStack{
+    typedef T value_type;
+
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    canary_t canary_beg = 0;
+#endif
+    T*     data     = NULL;
+    void*  raw_data = NULL;
+
+    size_t capacity = 0;
+    size_t size     = 0;
+    size_t reserved = 0;
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+    hash_t infoHash = 0;
+    hash_t dataHash = 0;
+#endif
+#ifdef STACK_META_INFORMATION
+    Location location  = {};
+#endif
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    canary_t canary_end = 0;
+#endif
+};
+
+/*!
+ * State of TypedStack of any type, filled by typed_stack_dump_info() for dumps.
+ */
+struct TypedStackDumpInfo{
+    const void* stack;
+    const void* raw_data;
+    const void* data;
+    size_t      size;
+    size_t      capacity;
+    size_t      reserved;
+    bool        data_ok;            //Data pointer, size and info hash are correct, so data may be read
+#ifdef STACK_META_INFORMATION
+    Location    location;
+#endif
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    canary_t    canary_value;       //Expected value of all canaries
+    canary_t    canary_beg;
+    canary_t    canary_end;
+    canary_t    data_canary_beg;
+    canary_t    data_canary_end;
+#endif
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+    hash_t      infoHash;
+    hash_t      realInfoHash;
+    hash_t      dataHash;
+    hash_t      realDataHash;
+#endif
+};
+
+//=================================== Untyped helpers. Defined in TypedStack.cpp =======================================
+
+/*!
+ * Logs error, dumps stack and raises.
+ * @param error - error to log
+ * @param info - state of stack
+ * @param location - place of dump
+ */
+STACK_ERROR typed_stack_log_error(STACK_ERROR error, const TypedStackDumpInfo* info, Location location);
+
+/*!
+ * Dumps stack info to log.
+ * @param info - state of stack
+ * @param location
+ */
+void typed_stack_dump(const TypedStackDumpInfo* info, Location location);
+
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+/*!
+ * Returns canary value of stack at address [stack].
+ */
+canary_t typed_stack_canary(const void* stack);
+#endif
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+/*!
+ * Counts hash of [size] bytes.
+ */
+hash_t typed_stack_hash(const void* bytes, size_t size);
+#endif
+
+//============================================ Internal functions ======================================================
+
+const size_t MIN_TYPED_STACK_SZ = 8;
+
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+const size_t TYPED_STACK_CANARY_SZ = sizeof(canary_t);
+#else
+const size_t TYPED_STACK_CANARY_SZ = 0;
+#endif
+
+#define TYPED_STACK_CHECK(stack) {STACK_ERROR _error = typed_stack_check(stack);if(_error != STACK_ERRNO) return _error;}
+
+/*!
+ * Offset of data from raw_data. Raw memory layout: [canary][padding][data][canary]
+ */
+template<typename T>
+constexpr size_t typed_stack_data_offset(){
+    return (TYPED_STACK_CANARY_SZ + alignof(T) - 1) / alignof(T) * alignof(T);
+}
+
+template<typename T>
+size_t typed_stack_raw_size(size_t capacity){
+    return typed_stack_data_offset<T>() + capacity * sizeof(T) + TYPED_STACK_CANARY_SZ;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+//Hashes fields from data to reserved.
+template<typename T>
+hash_t typed_stack_info_hash(const TypedStack<T>* stack){
+    return typed_stack_hash(&stack->data, (size_t)((const char*)(&stack->reserved + 1) - (const char*)&stack->data));
+}
+
+template<typename T>
+hash_t typed_stack_data_hash(const TypedStack<T>* stack){
+    return stack_hash_elements<T>::value ? typed_stack_hash(stack->data, stack->size * sizeof(T)) : 0;
+}
+#endif
+
+template<typename T>
+void typed_stack_reHash(TypedStack<T>* stack){
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+    stack->dataHash = typed_stack_data_hash(stack);
+    stack->infoHash = typed_stack_info_hash(stack);
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/*!
+ * Collects state of stack for dump. Data is read only if information about it is correct.
+ */
+template<typename T>
+TypedStackDumpInfo typed_stack_dump_info(const TypedStack<T>* stack){
+    TypedStackDumpInfo info = {};
+    info.stack = stack;
+    if(stack == NULL){
+        return info;
+    }
+
+    info.raw_data = stack->raw_data;
+    info.data     = stack->data;
+    info.size     = stack->size;
+    info.capacity = stack->capacity;
+    info.reserved = stack->reserved;
+    info.data_ok  = stack->data != NULL && stack->raw_data != NULL && stack->size <= stack->capacity &&
+                    (const char*)stack->data == (const char*)stack->raw_data + typed_stack_data_offset<T>();
+#ifdef STACK_META_INFORMATION
+    info.location = stack->location;
+#endif
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+    info.infoHash     = stack->infoHash;
+    info.realInfoHash = typed_stack_info_hash(stack);
+    info.data_ok      = info.data_ok && info.infoHash == info.realInfoHash;
+    info.dataHash     = stack->dataHash;
+    info.realDataHash = info.data_ok ? typed_stack_data_hash(stack) : 0;
+#endif
+
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    info.canary_value = typed_stack_canary(stack);
+    info.canary_beg   = stack->canary_beg;
+    info.canary_end   = stack->canary_end;
+    if(info.data_ok){
+        memcpy(&info.data_canary_beg, stack->raw_data, sizeof(canary_t));
+        memcpy(&info.data_canary_end, (const char*)(stack->data + stack->capacity), sizeof(canary_t));
+    }
+#endif
+    return info;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template<typename T>
+STACK_ERROR typed_stack_log_error(STACK_ERROR error, const TypedStack<T>* stack){
+    TypedStackDumpInfo info = typed_stack_dump_info(stack);
+    return typed_stack_log_error(error, &info, LOCATION(stack));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template<typename T>
+void typed_stack_place_canary(TypedStack<T>* stack){
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    canary_t local_canary_value = typed_stack_canary(stack);
+    memcpy(stack->raw_data, &local_canary_value, sizeof(canary_t));
+    memcpy((char*)(stack->data + stack->capacity), &local_canary_value, sizeof(canary_t));
+    stack->canary_beg = local_canary_value;
+    stack->canary_end = local_canary_value;
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template<typename T>
+STACK_ERROR typed_stack_check(TypedStack<T>* stack){
+    if(stack == NULL){
+        return typed_stack_log_error(STACK_NULL, stack);
+    }
+
+#if (STACK_PROTECTION_LEVEL) & STACK_VALID_CHECK
+    if(stack->data == NULL || stack->capacity == 0){
+        return typed_stack_log_error(STACK_UNINITIALIZED, stack);
+    }
+
+    if((char*)stack->data != (char*)stack->raw_data + typed_stack_data_offset<T>()){
+        return typed_stack_log_error(STACK_VALID_FAIL, stack);
+    }
+#endif
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+    if(typed_stack_info_hash(stack) != stack->infoHash){
+        return typed_stack_log_error(STACK_INFO_CORRUPTED, stack);
+    }
+
+    if(typed_stack_data_hash(stack) != stack->dataHash){
+        return typed_stack_log_error(STACK_DATA_CORRUPTED, stack);
+    }
+#endif
+
+#if (STACK_PROTECTION_LEVEL) & STACK_CANARY_CHECK
+    canary_t local_canary_value = typed_stack_canary(stack);
+    canary_t data_beg = 0;
+    canary_t data_end = 0;
+    memcpy(&data_beg, stack->raw_data, sizeof(canary_t));
+    memcpy(&data_end, (const char*)(stack->data + stack->capacity), sizeof(canary_t));
+
+    if(data_beg          != local_canary_value || data_end          != local_canary_value ||
+       stack->canary_beg != local_canary_value || stack->canary_end != local_canary_value){
+        return typed_stack_log_error(STACK_CANARY_DEATH, stack);
+    }
+#endif
+
+#if (STACK_PROTECTION_LEVEL) & STACK_VALID_CHECK
+    if(stack->size > stack->capacity){
+        return typed_stack_log_error(STACK_SIZE_CORRUPTED, stack);
+    }
+#endif
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/*!
+ * Moves elements with realloc(). Used for trivially relocatable types.
+ */
+template<typename T>
+void* typed_stack_relocate(TypedStack<T>* stack, size_t new_capacity, std::true_type){
+    return realloc(stack->raw_data, typed_stack_raw_size<T>(new_capacity));
+}
+
+/*!
+ * Moves elements one by one to new memory. Elements with throwing move are copied if they are copyable,
+ * so if exception is thrown stack stays unchanged.
+ * @warning Move-only types with throwing move may lose already moved elements if move throws.
+ */
+template<typename T>
+void* typed_stack_relocate(TypedStack<T>* stack, size_t new_capacity, std::false_type){
+    void* new_raw_data = malloc(typed_stack_raw_size<T>(new_capacity));
+    if(new_raw_data == NULL){
+        return NULL;
+    }
+    T* new_data = (T*)((char*)new_raw_data + typed_stack_data_offset<T>());
+
+    size_t moved = 0;
+    try{
+        for(; moved < stack->size; ++moved){
+            new (new_data + moved) T(std::move_if_noexcept(stack->data[moved]));
+        }
+    }
+    catch(...){
+        for(size_t i = 0; i < moved; ++i){
+            new_data[i].~T();
+        }
+        free(new_raw_data);
+        throw;
+    }
+
+    for(size_t i = 0; i < stack->size; ++i){
+        stack->data[i].~T();
+    }
+    free(stack->raw_data);
+    return new_raw_data;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template<typename T>
+STACK_ERROR typed_stack_realloc(TypedStack<T>* stack, size_t new_capacity){
+    TYPED_STACK_CHECK(stack)
+    if(stack->size > new_capacity || new_capacity == 0){
+        return typed_stack_log_error(STACK_WRONG_REALLOC, stack);
+    }
+
+    void* new_raw_data = typed_stack_relocate(stack, new_capacity, stack_is_trivially_relocatable<T>());
+    if(new_raw_data == NULL){
+        return typed_stack_log_error(STACK_BAD_REALLOC, stack);
+    }
+    stack->raw_data = new_raw_data;
+    stack->data     = (T*)((char*)stack->raw_data + typed_stack_data_offset<T>());
+    stack->capacity = new_capacity;
+
+    typed_stack_place_canary(stack);
+    typed_stack_reHash(stack);
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/*!
+ * Constructs element after top of stack. Stack must have free place.
+ */
+template<typename T, typename... Args>
+STACK_ERROR typed_stack_construct_top(TypedStack<T>* stack, Args&&... args){
+    new (stack->data + stack->size) T(std::forward<Args>(args)...);
+    stack->size++;
+
+    typed_stack_reHash(stack);
+    TYPED_STACK_CHECK(stack)
+    return STACK_ERRNO;
+}
+
+//============================================= Public functions =======================================================
+
+/*!
+ * Inits stack if it wasn't initialized before.
+ * @param stack - stack to init
+ */
+template<typename T>
+#ifdef STACK_META_INFORMATION
+STACK_ERROR stack_init_meta(TypedStack<T>* stack, Location location){
+#else
+STACK_ERROR stack_init(TypedStack<T>* stack){
+#endif
+    static_assert(alignof(T) <= alignof(max_align_t), "Over-aligned types are not supported");
+    if(stack == NULL){
+        return typed_stack_log_error(STACK_NULL, stack);
+    }
+    if(stack->data != NULL){
+        return typed_stack_log_error(STACK_REINIT, stack);
+    }
+#ifdef STACK_META_INFORMATION
+    stack->location = location;
+#endif
+
+    stack->raw_data = malloc(typed_stack_raw_size<T>(MIN_TYPED_STACK_SZ));
+    if(stack->raw_data == NULL){
+        return typed_stack_log_error(STACK_BAD_ALLOC, stack);
+    }
+
+    stack->capacity = MIN_TYPED_STACK_SZ;
+    stack->size     = 0;
+    stack->data     = (T*)((char*)stack->raw_data + typed_stack_data_offset<T>());
+
+    typed_stack_place_canary(stack);
+    typed_stack_reHash(stack);
+
+    TYPED_STACK_CHECK(stack)
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/*!
+ * Destroys all elements and frees place taken by stack.
+ * @param stack
+ */
+template<typename T>
+void stack_free(TypedStack<T>* stack){
+    if(stack == NULL) return;
+    if(stack->raw_data != NULL){
+        for(size_t i = 0; i < stack->size; ++i){
+            stack->data[i].~T();
+        }
+        free(stack->raw_data);
+        stack->raw_data = NULL;
+        stack->data     = NULL;
+        stack->size     = 0;
+        stack->capacity = 0;
+        stack->reserved = 0;
+
+#if (STACK_PROTECTION_LEVEL) & STACK_HASH_CHECK
+        stack->infoHash = 0;
+        stack->dataHash = 0;
+#endif
+
+    }
+    else{
+        typed_stack_log_error(STACK_REFREE, stack);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/*!
+ * Constructs element at top of stack from [args].
+ * @param stack
+ * @param args - arguments of constructor of T
+ */
+template<typename T, typename... Args>
+STACK_ERROR stack_emplace(TypedStack<T>* stack, Args&&... args){
+    TYPED_STACK_CHECK(stack)
+    if(stack->size == stack->capacity){                 //Expanding stack
+        T value(std::forward<Args>(args)...);           //Args may refer to element of stack, so they are used before relocation
+        STACK_ERROR error = typed_stack_realloc(stack, stack->capacity * 2);
+        if(error != STACK_ERRNO){
+            return error;
+        }
+        return typed_stack_construct_top(stack, std::move(value));
+    }
+    return typed_stack_construct_top(stack, std::forward<Args>(args)...);
+}
+
+/*!
+ * Pushes value to top of stack. T is deduced from stack only, so value may be converted, e.g. "abc" to std::string.
+ * @param stack - stack
+ * @param val - value to push
+ */
+template<typename T>
+STACK_ERROR stack_push(TypedStack<T>* stack, const typename TypedStack<T>::value_type& val){
+    return stack_emplace(stack, val);
+}
+
+template<typename T>
+STACK_ERROR stack_push(TypedStack<T>* stack, typename TypedStack<T>::value_type&& val){
+    return stack_emplace(stack, std::move(val));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/*!
+ * Returns pointer to top element of stack. Element must not be changed through it.
+ * @param stack
+ * @param value - pointer to top element
+ */
+template<typename T>
+STACK_ERROR stack_get(TypedStack<T>* stack, const T** value){
+    TYPED_STACK_CHECK(stack)
+    if(value == NULL){
+        return typed_stack_log_error(STACK_NULL, stack);
+    }
+
+    if(stack->size == 0){
+        return typed_stack_log_error(STACK_EMPTY_GET, stack);
+    }
+
+    *value = stack->data + stack->size - 1;
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/*!
+ * Removes top element from stack. If [value] is not NULL, element is moved to it before destruction.
+ * @param stack
+ * @param value
+ */
+template<typename T>
+STACK_ERROR stack_pop(TypedStack<T>* stack, T* value = NULL){
+    TYPED_STACK_CHECK(stack)
+
+    if(stack->size == 0){
+        return typed_stack_log_error(STACK_EMPTY_POP, stack);
+    }
+
+    T* top = stack->data + stack->size - 1;
+    if(value != NULL){
+        *value = std::move(*top);
+    }
+    top->~T();
+    stack->size--;
+    typed_stack_reHash(stack);
+
+    if(4 * stack->size < stack->capacity && stack->capacity > 4 * MIN_TYPED_STACK_SZ && stack->reserved <= stack->capacity / 2)
+        return typed_stack_realloc(stack, stack->capacity / 2);
+
+    TYPED_STACK_CHECK(stack)
+    return STACK_ERRNO;
+}
+
+/*!
+ * Removes top from stack.
+ * @param stack
+ */
+template<typename T>
+STACK_ERROR stack_remove(TypedStack<T>* stack){
+    return stack_pop(stack, (T*)NULL);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/*!
+ * Preserves stack capacity to [to_reserve]
+ * @param stack
+ * @param to_reserve
+ */
+template<typename T>
+STACK_ERROR stack_reserve(TypedStack<T>* stack, size_t to_reserve){
+    TYPED_STACK_CHECK(stack)
+    stack->reserved = to_reserve;
+    typed_stack_reHash(stack);
+
+    if(stack->reserved > stack->capacity){
+        return typed_stack_realloc(stack, stack->reserved);
+    }
+    TYPED_STACK_CHECK(stack)
+    return STACK_ERRNO;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/*!
+ * Dumps stack info to log.
+ * @param stack
+ */
+template<typename T>
+void stack_dump(const TypedStack<T>* stack, Location location){
+    TypedStackDumpInfo info = typed_stack_dump_info(stack);
+    typed_stack_dump(&info, location);
+}
+
+#endif //STACK_TYPEDSTACK_H
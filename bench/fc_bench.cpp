@@ -0,0 +1,167 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../lib/Logger.h"
+#include "../Stack.h"
+#include "../FcStack.h"
+
+/**
+ * @brief Contention benchmark: every thread does push-pop pairs on one shared stack.
+ * Compares mutex-wrapped Stack, flat-combining FcStack and lock-free Treiber stack.
+ * Treiber stack has no integrity checks, so it shows the cost of protection.
+ * Usage: fc_bench [prefill] [ops]. Stacks are prefilled, as cost of integrity checks grows with capacity.
+ */
+
+const size_t BENCH_PREFILL = 4000;      //Elements pushed before measuring
+const size_t BENCH_OPS     = 2000;      //Push-pop pairs per thread
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct MutexStack{
+    Stack      stack = {};
+    std::mutex lock;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const u_int32_t LF_NIL = 0xffffffff;
+
+struct LfNode{
+    stack_element_t        value = 0;
+    std::atomic<u_int32_t> next  = {LF_NIL};
+};
+
+/**
+ * @brief Treiber stack over preallocated nodes. Head holds index of node and ABA tag.
+ */
+struct LfStack{
+    std::vector<LfNode>    nodes;
+    std::atomic<u_int64_t> head  = {LF_NIL};
+    std::atomic<u_int64_t> free  = {LF_NIL};
+
+    explicit LfStack(size_t capacity): nodes(capacity){
+        for(size_t i = 0; i < capacity; ++i)
+            list_push(&free, (u_int32_t)i);
+    }
+
+    void list_push(std::atomic<u_int64_t>* list, u_int32_t node){
+        u_int64_t old = list->load(std::memory_order_relaxed);
+        u_int64_t top = 0;
+        do{
+            nodes[node].next.store((u_int32_t)old, std::memory_order_relaxed);
+            top = ((old >> 32) + 1) << 32 | node;
+        }while(!list->compare_exchange_weak(old, top, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    u_int32_t list_pop(std::atomic<u_int64_t>* list){
+        u_int64_t old = list->load(std::memory_order_acquire);
+        u_int64_t top = 0;
+        do{
+            if((u_int32_t)old == LF_NIL)
+                return LF_NIL;
+            u_int32_t next = nodes[(u_int32_t)old].next.load(std::memory_order_relaxed);
+            top = ((old >> 32) + 1) << 32 | next;
+        }while(!list->compare_exchange_weak(old, top, std::memory_order_acquire, std::memory_order_acquire));
+        return (u_int32_t)old;
+    }
+
+    bool push(stack_element_t value){
+        u_int32_t node = list_pop(&free);
+        if(node == LF_NIL)
+            return false;
+        nodes[node].value = value;
+        list_push(&head, node);
+        return true;
+    }
+
+    bool pop(stack_element_t* value){
+        u_int32_t node = list_pop(&head);
+        if(node == LF_NIL)
+            return false;
+        *value = nodes[node].value;
+        list_push(&free, node);
+        return true;
+    }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template<typename Worker>
+double bench_run(size_t threads, size_t ops, Worker worker){
+    std::vector<std::thread> pool;
+    auto begin = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < threads; ++i)
+        pool.emplace_back(worker, i);
+    for(std::thread& thread: pool)
+        thread.join();
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - begin;
+
+    return (double)(2 * ops * threads) / time.count() / 1e3;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv){
+    size_t prefill = (argc > 1) ? strtoul(argv[1], NULL, 10) : BENCH_PREFILL;
+    size_t ops     = (argc > 2) ? strtoul(argv[2], NULL, 10) : BENCH_OPS;
+
+    printf("prefill %zu, %zu push-pop pairs per thread\n", prefill, ops);
+    printf("%8s %14s %14s %14s\n", "threads", "mutex Kops/s", "fc Kops/s", "lockfree Kops/s");
+
+    for(size_t threads = 1; threads <= 16 && threads <= STACK_FC_SLOTS; threads *= 2){
+        MutexStack mutex_stack;
+        stack_init(&mutex_stack.stack);
+        for(size_t i = 0; i < prefill; ++i)
+            stack_push(&mutex_stack.stack, (stack_element_t)i);
+        double mutex_speed = bench_run(threads, ops, [&](size_t id){
+            stack_element_t value = 0;
+            for(size_t i = 0; i < ops; ++i){
+                {
+                    std::lock_guard<std::mutex> guard(mutex_stack.lock);
+                    stack_push(&mutex_stack.stack, (stack_element_t)id);
+                }
+                std::lock_guard<std::mutex> guard(mutex_stack.lock);
+                stack_pop(&mutex_stack.stack, &value);
+            }
+        });
+        stack_free(&mutex_stack.stack);
+
+        FcStack* fc_stack = new FcStack;
+        stack_init(fc_stack);
+        size_t fill_slot = 0;
+        fc_stack_attach(fc_stack, &fill_slot);
+        for(size_t i = 0; i < prefill; ++i)
+            stack_push(fc_stack, fill_slot, (stack_element_t)i);
+        fc_stack_detach(fc_stack, fill_slot);
+        double fc_speed = bench_run(threads, ops, [&](size_t id){
+            size_t slot = 0;
+            fc_stack_attach(fc_stack, &slot);
+            stack_element_t value = 0;
+            for(size_t i = 0; i < ops; ++i){
+                stack_push(fc_stack, slot, (stack_element_t)id);
+                stack_pop(fc_stack, slot, &value);
+            }
+            fc_stack_detach(fc_stack, slot);
+        });
+        stack_free(fc_stack);
+        delete fc_stack;
+
+        LfStack lf_stack(prefill + 4 * threads);
+        for(size_t i = 0; i < prefill; ++i)
+            lf_stack.push((stack_element_t)i);
+        double lf_speed = bench_run(threads, ops, [&](size_t id){
+            stack_element_t value = 0;
+            for(size_t i = 0; i < ops; ++i){
+                lf_stack.push((stack_element_t)id);
+                lf_stack.pop(&value);
+            }
+        });
+
+        printf("%8zu %14.1f %14.1f %14.1f\n", threads, mutex_speed, fc_speed, lf_speed);
+    }
+    return 0;
+}
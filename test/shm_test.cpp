@@ -0,0 +1,112 @@
+#include "stdio.h"
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../lib/Logger.h"
+#include "../ShmStack.h"
+
+/**
+ * @brief Cross-process check of ShmStack: values pushed by one process are popped by another,
+ * and stack survives death of a process holding the lock, also in the middle of operation.
+ */
+
+const size_t SHM_TEST_CAPACITY = 64;
+const int    SHM_TEST_VALUES   = 10;
+
+#define SHM_TEST_ASSERT(cond)                                                           \
+    if(!(cond)){                                                                        \
+        printf("FAILED: %s in %s(%i)\n", #cond, __FILE__, __LINE__);                    \
+        return 1;                                                                       \
+    }
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Runs func() in child process and waits for it.
+ * @return exit code of child
+ */
+template<typename Func>
+static int shm_test_in_child(Func func){
+    fflush(stdout);
+    pid_t pid = fork();
+    if(pid == 0){
+        _exit(func());
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(){
+    size_t bytes = shm_stack_size(SHM_TEST_CAPACITY);
+    void* memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    SHM_TEST_ASSERT(memory != MAP_FAILED);
+
+    ShmStack* stack = NULL;
+    SHM_TEST_ASSERT(shm_stack_create(memory, bytes, &stack) == STACK_ERRNO);
+
+    //Child pushes, parent pops.
+    int child = shm_test_in_child([&](){
+        ShmStack* child_stack = NULL;
+        if(shm_stack_attach(memory, &child_stack) != STACK_ERRNO)
+            return 1;
+        for(int i = 0; i < SHM_TEST_VALUES; ++i){
+            if(stack_push(child_stack, (stack_element_t)i) != STACK_ERRNO)
+                return 1;
+        }
+        return 0;
+    });
+    SHM_TEST_ASSERT(child == 0);
+    SHM_TEST_ASSERT(stack->size == SHM_TEST_VALUES);
+
+    stack_element_t value = 0;
+    for(int i = SHM_TEST_VALUES - 1; i >= SHM_TEST_VALUES / 2; --i){
+        SHM_TEST_ASSERT(stack_pop(stack, &value) == STACK_ERRNO);
+        SHM_TEST_ASSERT(value == (stack_element_t)i);
+    }
+
+    //Child dies holding the lock.
+    shm_test_in_child([&](){
+        pthread_mutex_lock(&stack->lock);
+        return 0;
+    });
+    SHM_TEST_ASSERT(stack_push(stack, (stack_element_t)100) == STACK_ERRNO);
+    SHM_TEST_ASSERT(stack->size == SHM_TEST_VALUES / 2 + 1);
+    SHM_TEST_ASSERT(stack_pop(stack, &value) == STACK_ERRNO && value == (stack_element_t)100);
+
+    //Child dies in the middle of push: value is written, but operation is not finished.
+    shm_test_in_child([&](){
+        stack_push(stack, (stack_element_t)200);
+        pthread_mutex_lock(&stack->lock);
+        stack->pending_size  = stack->size - 1;
+        stack->pending_value = 0;
+        stack->pending_op    = SHM_STACK_PUSH;
+        return 0;
+    });
+    SHM_TEST_ASSERT(stack_get(stack, &value) == STACK_ERRNO);
+    SHM_TEST_ASSERT(stack->size == SHM_TEST_VALUES / 2);
+    SHM_TEST_ASSERT(value == (stack_element_t)(SHM_TEST_VALUES / 2 - 1));
+
+    //Child dies in the middle of pop: value is removed, but operation is not finished.
+    shm_test_in_child([&](){
+        stack_element_t popped = 0;
+        stack_pop(stack, &popped);
+        pthread_mutex_lock(&stack->lock);
+        stack->pending_size  = stack->size + 1;
+        stack->pending_value = popped;
+        stack->pending_op    = SHM_STACK_POP;
+        return 0;
+    });
+    for(int i = SHM_TEST_VALUES / 2 - 1; i >= 0; --i){
+        SHM_TEST_ASSERT(stack_pop(stack, &value) == STACK_ERRNO);
+        SHM_TEST_ASSERT(value == (stack_element_t)i);
+    }
+    SHM_TEST_ASSERT(stack->size == 0);
+
+    shm_stack_destroy(stack);
+    munmap(memory, bytes);
+    printf("OK\n");
+    return 0;
+}
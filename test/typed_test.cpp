@@ -0,0 +1,56 @@
+#include "stdio.h"
+#include <string>
+#include "../lib/Logger.h"
+#include "../TypedStack.h"
+
+/**
+ * @brief Check of TypedStack: pushing element of the same stack when push expands stack.
+ */
+
+#define TYPED_TEST_ASSERT(cond)                                                         \
+    if(!(cond)){                                                                        \
+        printf("FAILED: %s in %s(%i)\n", #cond, __FILE__, __LINE__);                    \
+        return 1;                                                                       \
+    }
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Fills stack up to capacity with make(i), then pushes copy of top, so push has to expand stack.
+ */
+template<typename T, typename Make>
+static int typed_test_push_top(Make make){
+    TypedStack<T> stack = {};
+    TYPED_TEST_ASSERT(stack_init(&stack) == STACK_ERRNO);
+
+    for(size_t i = 0; stack.size < stack.capacity; ++i){
+        TYPED_TEST_ASSERT(stack_push(&stack, make(i)) == STACK_ERRNO);
+    }
+    size_t capacity = stack.capacity;
+
+    const T* top = NULL;
+    TYPED_TEST_ASSERT(stack_get(&stack, &top) == STACK_ERRNO);
+    TYPED_TEST_ASSERT(stack_push(&stack, *top) == STACK_ERRNO);
+    TYPED_TEST_ASSERT(stack.capacity > capacity);
+
+    T first  = {};
+    T second = {};
+    TYPED_TEST_ASSERT(stack_pop(&stack, &first)  == STACK_ERRNO);
+    TYPED_TEST_ASSERT(stack_pop(&stack, &second) == STACK_ERRNO);
+    TYPED_TEST_ASSERT(first == second && first == make(capacity - 1));
+
+    stack_free(&stack);
+    return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(){
+    if(typed_test_push_top<int>([](size_t i){ return (int)i; }))
+        return 1;
+    if(typed_test_push_top<std::string>([](size_t i){ return std::string(64, (char)('a' + i)); }))
+        return 1;
+
+    printf("OK\n");
+    return 0;
+}